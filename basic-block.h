@@ -34,6 +34,40 @@ extern int regset_size;
 
 #define REGSET_ELT_BITS HOST_BITS_PER_INT
 
+/* Test, set or clear the bit for register REGNO in the regset SET.  */
+
+#define REGNO_REG_SET_P(SET, REGNO) \
+  ((SET)[(REGNO) / REGSET_ELT_BITS] & (1 << ((REGNO) % REGSET_ELT_BITS)))
+#define SET_REGNO_REG_SET(SET, REGNO) \
+  ((SET)[(REGNO) / REGSET_ELT_BITS] |= 1 << ((REGNO) % REGSET_ELT_BITS))
+#define CLEAR_REGNO_REG_SET(SET, REGNO) \
+  ((SET)[(REGNO) / REGSET_ELT_BITS] &= ~(1 << ((REGNO) % REGSET_ELT_BITS)))
+
+/* Execute CODE for each register whose bit is on in the regset SET,
+   with REGNUM set to its register number, in increasing order.
+   Words that are all zero are skipped quickly.
+   CODE must not use `break' or `continue'.  */
+
+#define EXECUTE_IF_SET_IN_REG_SET(SET, REGNUM, CODE)  \
+{ register regset rs_p = (SET);					\
+  register int rs_i;						\
+  for (rs_i = 0; rs_i < regset_size; rs_i++)			\
+    {								\
+      register unsigned rs_word = rs_p[rs_i];			\
+      register int rs_j;					\
+      for (rs_j = 0; rs_word != 0; rs_j++, rs_word >>= 1)	\
+	if (rs_word & 1)					\
+	  {							\
+	    (REGNUM) = rs_i * REGSET_ELT_BITS + rs_j;		\
+	    CODE;						\
+	  }							\
+    }								\
+}
+
+/* Copy the regset FROM into TO.  */
+
+#define COPY_REG_SET(TO, FROM) bcopy ((FROM), (TO), regset_bytes)
+
 /* Number of basic blocks in the current function.  */
 
 extern int n_basic_blocks;
@@ -55,4 +89,4 @@ extern regset *basic_block_live_at_start;
    Or gives -2 if (REG n) is used in more than one basic block.
    Or -1 if it has not yet been seen so no basic block is known.  */
 
-extern short *reg_basic_block;
+extern int *reg_basic_block;
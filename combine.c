@@ -49,8 +49,11 @@ and this notice must be preserved on all copies.  */
    information (LOG_LINKS and REG_NOTES) for what we did.
 
    To simplify substitution, we combine only when the earlier insn(s)
-   consist of only a single assignment.  To simplify updating afterward,
-   we never combine when a subroutine call appears in the middle.
+   consist of only a single assignment.  When a subroutine call appears
+   in the middle, the regs used by the earlier insns come to live across
+   the call; we allow that only for pseudo regs, whose reg_crosses_call
+   we then set, and only if it does not add to the values that must
+   be kept across the call.
 
    Since we do not represent assignments to CC0 explicitly except when that
    is all an insn does, there is no LOG_LINKS entry in an insn that uses
@@ -87,9 +90,41 @@ static int combine_extras;
 
 static int combine_successes;
 
+/* Number of those combinations that moved values across a call.  */
+
+static int combine_call_successes;
+
+/* Number of attempts, in this function, that failed for each reason,
+   and number of attempts not made because the same insns had
+   already failed to combine in the same state.  */
+
+enum combine_failure
+{
+  CF_USED_UP,			/* an earlier insn was already combined */
+  CF_CALL,			/* a call insn comes in between */
+  CF_FORM,			/* an earlier insn is not a suitable SET */
+  CF_CROSSES_SET,		/* an input is altered in between */
+  CF_AUTO_INC,			/* an autoincrement gets in the way */
+  CF_RECOG,			/* the combined insn is not recognized */
+  CF_MAX
+};
+
+static int combine_failures[(int) CF_MAX];
+static int combine_repeats;
+
+/* Number of combined patterns looked up in the cache of `recog' results,
+   in this function, and how many of them were found there.  */
+
+static int combine_recog_lookups;
+static int combine_recog_hits;
+
 /* Totals over entire compilation.  */
 
 static int total_attempts, total_merges, total_extras, total_successes;
+static int total_call_successes;
+static int total_failures[(int) CF_MAX];
+static int total_repeats;
+static int total_recog_lookups, total_recog_hits;
 
 
 /* Vector mapping INSN_UIDs to cuids.
@@ -99,12 +134,34 @@ static int total_attempts, total_merges, total_extras, total_successes;
    proves to be a bad idea because it makes it hard to compare
    the dumps produced by earlier passes with those from later passes.  */
 
-static short *uid_cuid;
+static int *uid_cuid;
 
 /* Get the cuid of an insn.  */
 
 #define INSN_CUID(INSN) (uid_cuid[INSN_UID (INSN)])
 
+/* Vector mapping INSN_UIDs to version numbers.  The version of an insn
+   is incremented whenever combine changes its pattern or its REG_NOTES,
+   which are all that try_combine looks at in an insn.  */
+
+static int *uid_version;
+
+#define INSN_VERSION(INSN) (uid_version[INSN_UID (INSN)])
+
+/* Hash table of the combinations that have failed: each entry
+   is six ints, the uid and version of I3, of I2 and of I1
+   (or two zeros if there was no I1), with a uid of zero for an
+   empty entry.  When an attempt is repeated with none of the insns
+   changed, it would fail again, so it is not made.  */
+
+static int *combine_fail_hash;
+static int combine_fail_hash_size;
+static int combine_fail_hash_count;
+
+#ifndef COMBINE_FAIL_HASH_SIZE
+#define COMBINE_FAIL_HASH_SIZE 256
+#endif
+
 
 /* Record last point of death of (hard or pseudo) register n.  */
 
@@ -167,10 +224,20 @@ static rtx subst ();
 static void undo_all ();
 static void add_links ();
 static void add_incs ();
-static int adjacent_insns_p ();
+static void move_links ();
+static int count_new_call_crossings ();
+static int hard_reg_use_p ();
+static int inc_note_p ();
+static void mark_regs_crossing_call ();
 static rtx simplify_and_const_int ();
 static rtx gen_lowpart_for_combine ();
 static void simplify_set_cc0_and ();
+static int try_combine_1 ();
+static int *combine_fail_slot ();
+static void record_combine_failure ();
+
+extern int xmalloc ();
+extern void free ();
 
 /* Main entry point for combiner.  F is the first insn of the function.
    NREGS is the first unused pseudo-reg number.  */
@@ -184,11 +251,16 @@ combine_instructions (f, nregs)
   register int i;
   register rtx links, nextlinks;
   rtx prev;
+  int recog_lookups = recog_cache_lookups;
+  int recog_hits = recog_cache_hits;
 
   combine_attempts = 0;
   combine_merges = 0;
   combine_extras = 0;
   combine_successes = 0;
+  combine_call_successes = 0;
+  combine_repeats = 0;
+  bzero (combine_failures, sizeof combine_failures);
 
   reg_last_death = (rtx *) alloca (nregs * sizeof (rtx));
   reg_last_set = (rtx *) alloca (nregs * sizeof (rtx));
@@ -203,7 +275,15 @@ combine_instructions (f, nregs)
     if (INSN_UID (insn) > i)
       i = INSN_UID (insn);
 
-  uid_cuid = (short *) alloca ((i + 1) * sizeof (short));
+  uid_cuid = (int *) alloca ((i + 1) * sizeof (int));
+  uid_version = (int *) alloca ((i + 1) * sizeof (int));
+  bzero (uid_version, (i + 1) * sizeof (int));
+
+  combine_fail_hash_size = COMBINE_FAIL_HASH_SIZE;
+  combine_fail_hash_count = 0;
+  combine_fail_hash
+    = (int *) xmalloc (6 * combine_fail_hash_size * sizeof (int));
+  bzero (combine_fail_hash, 6 * combine_fail_hash_size * sizeof (int));
 
   /* Compute the mapping from uids to cuids.
      Cuids are numbers assigned to insns, like uids,
@@ -293,6 +373,97 @@ combine_instructions (f, nregs)
   total_merges += combine_merges;
   total_extras += combine_extras;
   total_successes += combine_successes;
+  total_call_successes += combine_call_successes;
+  total_repeats += combine_repeats;
+  for (i = 0; i < (int) CF_MAX; i++)
+    total_failures[i] += combine_failures[i];
+  combine_recog_lookups = recog_cache_lookups - recog_lookups;
+  combine_recog_hits = recog_cache_hits - recog_hits;
+  total_recog_lookups += combine_recog_lookups;
+  total_recog_hits += combine_recog_hits;
+
+  free (combine_fail_hash);
+  combine_fail_hash = 0;
+}
+
+/* Return the entry in combine_fail_hash for combining I2 and I1 into I3,
+   as they are now.  The entry is empty if there is no record of it.  */
+
+static int *
+combine_fail_slot (i3, i2, i1)
+     rtx i3, i2, i1;
+{
+  int key[6];
+  register unsigned hash = 0;
+  register int i;
+  register int *entry;
+
+  key[0] = INSN_UID (i3);
+  key[1] = INSN_VERSION (i3);
+  key[2] = INSN_UID (i2);
+  key[3] = INSN_VERSION (i2);
+  key[4] = i1 ? INSN_UID (i1) : 0;
+  key[5] = i1 ? INSN_VERSION (i1) : 0;
+  for (i = 0; i < 6; i++)
+    hash = hash * 31 + key[i];
+  hash = (hash * 0x9e3779b1) >> 8;
+
+  while (1)
+    {
+      entry = combine_fail_hash + 6 * (hash & (combine_fail_hash_size - 1));
+      if (entry[0] == 0)
+	break;
+      for (i = 0; i < 6; i++)
+	if (entry[i] != key[i])
+	  break;
+      if (i == 6)
+	return entry;
+      hash++;
+    }
+
+  /* Leave the key in the empty entry, for record_combine_failure.  */
+  for (i = 1; i < 6; i++)
+    entry[i] = key[i];
+  return entry;
+}
+
+/* Record that combining I2 and I1 into I3 fails as they are now.  */
+
+static void
+record_combine_failure (i3, i2, i1)
+     rtx i3, i2, i1;
+{
+  register int *entry = combine_fail_slot (i3, i2, i1);
+  register int *old;
+  register int i, j;
+
+  if (entry[0] != 0)
+    return;
+  entry[0] = INSN_UID (i3);
+
+  if (++combine_fail_hash_count * 4 < combine_fail_hash_size * 3)
+    return;
+
+  /* The table is getting full: double its size and rehash.  */
+  old = combine_fail_hash;
+  combine_fail_hash_size *= 2;
+  combine_fail_hash
+    = (int *) xmalloc (6 * combine_fail_hash_size * sizeof (int));
+  bzero (combine_fail_hash, 6 * combine_fail_hash_size * sizeof (int));
+  for (i = 0; i < combine_fail_hash_size / 2; i++)
+    if (old[6 * i] != 0)
+      {
+	register unsigned hash = 0;
+	for (j = 0; j < 6; j++)
+	  hash = hash * 31 + old[6 * i + j];
+	hash = (hash * 0x9e3779b1) >> 8;
+	while (combine_fail_hash[6 * (hash & (combine_fail_hash_size - 1))])
+	  hash++;
+	bcopy (old + 6 * i,
+	       combine_fail_hash + 6 * (hash & (combine_fail_hash_size - 1)),
+	       6 * sizeof (int));
+      }
+  free (old);
 }
 
 /* Try to combine the insns I1 and I2 into I3.
@@ -301,11 +472,40 @@ combine_instructions (f, nregs)
  
    Return 1 if successful; if that happens, I1 and I2 are pseudo-deleted
    by turning them into NOTEs, and I3 is modified.
-   Return 0 if the combination does not work.  Then nothing is changed.  */
+   Return 0 if the combination does not work.  Then nothing is changed.
+
+   A combination that has failed is not tried again
+   until one of the insns involved has been changed.  */
 
 static int
 try_combine (i3, i2, i1)
      register rtx i3, i2, i1;
+{
+  combine_attempts++;
+
+  if (combine_fail_slot (i3, i2, i1)[0] != 0)
+    {
+      combine_repeats++;
+      return 0;
+    }
+
+  if (try_combine_1 (i3, i2, i1))
+    {
+      INSN_VERSION (i3)++;
+      combine_successes++;
+      return 1;
+    }
+
+  record_combine_failure (i3, i2, i1);
+  return 0;
+}
+
+/* Subroutine of try_combine, which does the actual work.
+   Each failure is counted in combine_failures by its reason.  */
+
+static int
+try_combine_1 (i3, i2, i1)
+     register rtx i3, i2, i1;
 {
   register rtx newpat;
   int added_sets_1 = 0;
@@ -317,22 +517,21 @@ try_combine (i3, i2, i1)
   int recog_flags = 0;
   rtx i2dest, i2src;
   rtx i1dest, i1src;
-
-  combine_attempts++;
+  int i2_crosses_call, i1_crosses_call;
 
   /* Don't combine with something already used up by combination.  */
 
   if (GET_CODE (i2) == NOTE
       || (i1 && GET_CODE (i1) == NOTE))
-    return 0;
+    {
+      combine_failures[(int) CF_USED_UP]++;
+      return 0;
+    }
 
-  /* Don't combine across a CALL_INSN, because that would possibly
-     change whether the life span of some REGs crosses calls or not,
-     and it is a pain to update that information.  */
+  /* Note whether a CALL_INSN comes between I2 or I1 and I3.  */
 
-  if (INSN_CUID (i2) < last_call_cuid
-      || (i1 && INSN_CUID (i1) < last_call_cuid))
-    return 0;
+  i2_crosses_call = INSN_CUID (i2) < last_call_cuid;
+  i1_crosses_call = i1 != 0 && INSN_CUID (i1) < last_call_cuid;
 
   /* Can combine only if previous insn is a SET of a REG, a SUBREG or CC0.
      That REG must be either set or dead by the final instruction
@@ -348,7 +547,10 @@ try_combine (i3, i2, i1)
      is handled by substituting (SUBREG:Y (something:X...)) for (REG:Y...).  */
 
   if (GET_CODE (PATTERN (i2)) != SET)
-    return 0;
+    {
+      combine_failures[(int) CF_FORM]++;
+      return 0;
+    }
   i2dest = SET_DEST (PATTERN (i2));
   i2src = SET_SRC (PATTERN (i2));
   if (GET_CODE (i2dest) == SUBREG)
@@ -358,14 +560,25 @@ try_combine (i3, i2, i1)
     }
   if (GET_CODE (i2dest) != CC0
       && (GET_CODE (i2dest) != REG
-	  || GET_CODE (i2src) == REG
-	  || use_crosses_set_p (i2src, INSN_CUID (i2))))
-    return 0;
+	  || GET_CODE (i2src) == REG))
+    {
+      combine_failures[(int) CF_FORM]++;
+      return 0;
+    }
+  if (GET_CODE (i2dest) != CC0
+      && use_crosses_set_p (i2src, INSN_CUID (i2)))
+    {
+      combine_failures[(int) CF_CROSSES_SET]++;
+      return 0;
+    }
 
   if (i1 != 0)
     {
       if (GET_CODE (PATTERN (i1)) != SET)
-	return 0;
+	{
+	  combine_failures[(int) CF_FORM]++;
+	  return 0;
+	}
       i1dest = SET_DEST (PATTERN (i1));
       i1src = SET_SRC (PATTERN (i1));
       if (GET_CODE (i1dest) == SUBREG)
@@ -375,9 +588,17 @@ try_combine (i3, i2, i1)
 	}
       if (GET_CODE (i1dest) != CC0
 	  && (GET_CODE (i1dest) != REG
-	      || GET_CODE (i1src) == REG
-	      || use_crosses_set_p (i1src, INSN_CUID (i1))))
-	return 0;
+	      || GET_CODE (i1src) == REG))
+	{
+	  combine_failures[(int) CF_FORM]++;
+	  return 0;
+	}
+      if (GET_CODE (i1dest) != CC0
+	  && use_crosses_set_p (i1src, INSN_CUID (i1)))
+	{
+	  combine_failures[(int) CF_CROSSES_SET]++;
+	  return 0;
+	}
     }
 
   /* If I1 or I2 contains an autoincrement or autodecrement,
@@ -388,14 +609,20 @@ try_combine (i3, i2, i1)
     if ((enum reg_note) GET_MODE (link) == REG_INC)
       if (GET_CODE (i3) == JUMP_INSN
 	  || reg_used_between_p (XEXP (link, 0), i2, i3))
-	return 0;
+	{
+	  combine_failures[(int) CF_AUTO_INC]++;
+	  return 0;
+	}
 
   if (i1)
     for (link = REG_NOTES (i1); link; link = XEXP (link, 1))
       if ((enum reg_note) GET_MODE (link) == REG_INC)
 	if (GET_CODE (i3) == JUMP_INSN
 	    || reg_used_between_p (XEXP (link, 0), i1, i3))
-	  return 0;
+	  {
+	    combine_failures[(int) CF_AUTO_INC]++;
+	    return 0;
+	  }
 
   /* See if the SETs in i1 or i2 need to be kept around in the merged
      instruction: whenever the value set there is still needed past i3.  */
@@ -405,6 +632,56 @@ try_combine (i3, i2, i1)
     added_sets_1 = ! (dead_or_set_p (i3, i1dest)
 		      || dead_or_set_p (i2, i1dest));
 
+  /* If I1's value must be kept, setting it in I3 instead
+     is wrong if some insn in between uses it.  */
+  if (added_sets_1 && reg_used_between_p (i1dest, i2, i3))
+    {
+      combine_failures[(int) CF_FORM]++;
+      return 0;
+    }
+
+  /* Moving the value computed by I2 or I1 past a call makes the regs
+     it uses live across the call.  A hard reg might be clobbered by the
+     call, and an autoincrement cannot be delayed past it.  For pseudo
+     regs, allow it if it does not add to the number of values live
+     across the call: either each reg used already lives across it,
+     or just one does not and I2's own value need no longer do so.
+     (use_crosses_set_p has already rejected any use of memory.)  */
+
+  if (i2_crosses_call || i1_crosses_call)
+    {
+      int new_crossings = 0;
+
+      if (GET_CODE (i2dest) == CC0)
+	{
+	  combine_failures[(int) CF_CALL]++;
+	  return 0;
+	}
+      if (i2_crosses_call)
+	{
+	  if (hard_reg_use_p (i2src) || inc_note_p (i2))
+	    {
+	      combine_failures[(int) CF_CALL]++;
+	      return 0;
+	    }
+	  new_crossings += count_new_call_crossings (i2src, INSN_CUID (i2), i3);
+	}
+      if (i1_crosses_call)
+	{
+	  if (hard_reg_use_p (i1src) || inc_note_p (i1))
+	    {
+	      combine_failures[(int) CF_CALL]++;
+	      return 0;
+	    }
+	  new_crossings += count_new_call_crossings (i1src, INSN_CUID (i1), i3);
+	}
+      if (new_crossings > (added_sets_2 ? 0 : 1))
+	{
+	  combine_failures[(int) CF_CALL]++;
+	  return 0;
+	}
+    }
+
   combine_merges++;
 
   undobuf.num_undo = 0;
@@ -474,7 +751,7 @@ try_combine (i3, i2, i1)
     }
 
   /* Is the result of combination a valid instruction?  */
-  insn_code_number = recog (newpat, i3);
+  insn_code_number = recog_cached (newpat, i3);
 
   if (insn_code_number >= 0)
     {
@@ -501,16 +778,17 @@ try_combine (i3, i2, i1)
 	      && ! reg_mentioned_p (i2dest, PATTERN (i3)))
 	    remove_death (regno, i3);
 	}
+      /* The regs used by I2 now live across any call before I3.  */
+      if (i2_crosses_call)
+	mark_regs_crossing_call (i2src);
       /* The data flowing into I2 now flows into I3.
 	 But we cannot always move I2's LOG_LINKS into I3,
 	 since they must go to a setting of a REG from the
 	 first use following.  If I2 was the first use following a set,
 	 I3 is now a use, but it is not the first use
 	 if some instruction between I2 and I3 is also a use.
-	 Here, for simplicity, we move the links only if
-	 there are no real insns between I2 and I3.  */
-      if (adjacent_insns_p (i2, i3))
-	add_links (i3, LOG_LINKS (i2));
+	 So move_links moves only the links for which that is not so.  */
+      move_links (i2, i3);
       /* Any registers previously autoincremented in I2
 	 are now incremented in I3.  */
       add_incs (i3, REG_NOTES (i2));
@@ -538,8 +816,9 @@ try_combine (i3, i2, i1)
 		  && ! reg_mentioned_p (i1dest, PATTERN (i3)))
 		remove_death (regno, i3);
 	    }
-	  if (adjacent_insns_p (i2, i3))
-	    add_links (i3, LOG_LINKS (i1));
+	  if (i1_crosses_call)
+	    mark_regs_crossing_call (i1src);
+	  move_links (i1, i3);
 	  add_incs (i3, REG_NOTES (i1));
 	  LOG_LINKS (i1) = 0;
 	  PUT_CODE (i1, NOTE);
@@ -547,13 +826,15 @@ try_combine (i3, i2, i1)
 	  NOTE_SOURCE_FILE (i1) = 0;
 	}
 
-      combine_successes++;
+      if (i2_crosses_call || i1_crosses_call)
+	combine_call_successes++;
       return 1;
     }
 
   /* Failure: change I3 back the way it was.  */
   undo_all ();
 
+  combine_failures[(int) CF_RECOG]++;
   return 0;
 }
 
@@ -1440,21 +1721,145 @@ remove_death (regno, insn)
       }
 }
 
-/* Return nonzero if J is the first insn following I,
-   not counting labels, line numbers, etc.
-   We assume that J follows I.  */
+/* FROM has just been combined into I3, which follows it.
+   Give I3 a copy of each of the LOG_LINKS of FROM that is still valid
+   for I3: a link to an insn that sets a REG that I3 now uses and that
+   no insn between FROM and I3 uses or sets.  */
+
+static void
+move_links (from, i3)
+     rtx from, i3;
+{
+  register rtx links, dest, tem;
+
+  for (links = LOG_LINKS (from); links; links = XEXP (links, 1))
+    {
+      if (GET_CODE (XEXP (links, 0)) == NOTE
+	  || GET_CODE (PATTERN (XEXP (links, 0))) != SET)
+	continue;
+      dest = SET_DEST (PATTERN (XEXP (links, 0)));
+      if (GET_CODE (dest) == SUBREG)
+	dest = SUBREG_REG (dest);
+      if (GET_CODE (dest) != REG
+	  || ! reg_mentioned_p (dest, PATTERN (i3))
+	  || reg_used_between_p (dest, from, i3))
+	continue;
+      for (tem = LOG_LINKS (i3); tem; tem = XEXP (tem, 1))
+	if (XEXP (tem, 0) == XEXP (links, 0))
+	  break;
+      if (tem == 0)
+	LOG_LINKS (i3) = gen_rtx (INSN_LIST, VOIDmode, XEXP (links, 0),
+				  LOG_LINKS (i3));
+    }
+}
+
+/* Return nonzero if X uses a hard reg whose value a call might change.  */
 
 static int
-adjacent_insns_p (i, j)
-     rtx i, j;
+hard_reg_use_p (x)
+     rtx x;
 {
-  register rtx insn;
-  for (insn = NEXT_INSN (i); insn != j; insn = NEXT_INSN (insn))
-    if (GET_CODE (insn) == INSN
-	|| GET_CODE (insn) == CALL_INSN
-	|| GET_CODE (insn) == JUMP_INSN)
-      return 0;
-  return 1;
+  register RTX_CODE code = GET_CODE (x);
+  register char *fmt;
+  register int i, j;
+
+  if (code == REG)
+    return (REGNO (x) < FIRST_PSEUDO_REGISTER
+	    && REGNO (x) != FRAME_POINTER_REGNUM
+	    && REGNO (x) != ARG_POINTER_REGNUM);
+
+  fmt = GET_RTX_FORMAT (code);
+  for (i = GET_RTX_LENGTH (code) - 1; i >= 0; i--)
+    {
+      if (fmt[i] == 'e')
+	{
+	  if (hard_reg_use_p (XEXP (x, i)))
+	    return 1;
+	}
+      else if (fmt[i] == 'E')
+	for (j = XVECLEN (x, i) - 1; j >= 0; j--)
+	  if (hard_reg_use_p (XVECEXP (x, i, j)))
+	    return 1;
+    }
+  return 0;
+}
+
+/* Return nonzero if INSN has a REG_INC note.  */
+
+static int
+inc_note_p (insn)
+     rtx insn;
+{
+  register rtx link;
+
+  for (link = REG_NOTES (insn); link; link = XEXP (link, 1))
+    if ((enum reg_note) GET_MODE (link) == REG_INC)
+      return 1;
+  return 0;
+}
+
+/* Return the number of uses of pseudo regs in X, which is being moved
+   from the insn with cuid FROM_CUID into I3, past a call, whose regs
+   now die before I3 and so do not yet live across the call.  */
+
+static int
+count_new_call_crossings (x, from_cuid, i3)
+     rtx x;
+     int from_cuid;
+     rtx i3;
+{
+  register RTX_CODE code = GET_CODE (x);
+  register char *fmt;
+  register int i, j;
+  register int count = 0;
+
+  if (code == REG)
+    {
+      register rtx where_dead = reg_last_death[REGNO (x)];
+      return (where_dead != 0
+	      && INSN_CUID (where_dead) >= from_cuid
+	      && INSN_CUID (where_dead) < INSN_CUID (i3));
+    }
+
+  fmt = GET_RTX_FORMAT (code);
+  for (i = GET_RTX_LENGTH (code) - 1; i >= 0; i--)
+    {
+      if (fmt[i] == 'e')
+	count += count_new_call_crossings (XEXP (x, i), from_cuid, i3);
+      else if (fmt[i] == 'E')
+	for (j = XVECLEN (x, i) - 1; j >= 0; j--)
+	  count += count_new_call_crossings (XVECEXP (x, i, j), from_cuid, i3);
+    }
+  return count;
+}
+
+/* Record that each pseudo reg used in X, which has been moved past
+   a call, now lives across a call.  */
+
+static void
+mark_regs_crossing_call (x)
+     rtx x;
+{
+  register RTX_CODE code = GET_CODE (x);
+  register char *fmt;
+  register int i, j;
+
+  if (code == REG)
+    {
+      if (REGNO (x) >= FIRST_PSEUDO_REGISTER)
+	reg_crosses_call[REGNO (x)] = 1;
+      return;
+    }
+
+  fmt = GET_RTX_FORMAT (code);
+  for (i = GET_RTX_LENGTH (code) - 1; i >= 0; i--)
+    {
+      if (fmt[i] == 'e')
+	mark_regs_crossing_call (XEXP (x, i));
+      else if (fmt[i] == 'E')
+	for (j = XVECLEN (x, i) - 1; j >= 0; j--)
+	  mark_regs_crossing_call (XVECEXP (x, i, j));
+    }
 }
 
 /* Concatenate the list of logical links LINKS
@@ -1517,6 +1922,7 @@ move_deaths (x, from_cuid, to_insn)
 	  && INSN_CUID (where_dead) < INSN_CUID (to_insn))
 	{
 	  remove_death (REGNO (x), reg_last_death[REGNO (x)]);
+	  INSN_VERSION (reg_last_death[REGNO (x)])++;
 	  if (! dead_or_set_p (to_insn, x))
 	    REG_NOTES (to_insn)
 	      = gen_rtx (EXPR_LIST, REG_DEAD, x, REG_NOTES (to_insn));
@@ -1540,13 +1946,45 @@ move_deaths (x, from_cuid, to_insn)
     }
 }
 
+/* Print the failure counts FAILURES, and REPEATS, the number of
+   attempts skipped because they were known to fail.  */
+
+static void
+dump_combine_failures (file, failures, repeats)
+     char *file;
+     int *failures;
+     int repeats;
+{
+  fprintf (file,
+	   ";; Failures: %d used up, %d across calls, %d unsuitable, %d inputs altered,\n;; %d autoincrements, %d not recognized; %d repeats skipped.\n",
+	   failures[(int) CF_USED_UP], failures[(int) CF_CALL],
+	   failures[(int) CF_FORM], failures[(int) CF_CROSSES_SET],
+	   failures[(int) CF_AUTO_INC], failures[(int) CF_RECOG], repeats);
+}
+
+/* Print LOOKUPS, the number of combined patterns looked up
+   in the cache of `recog' results, and HITS, how many were found.  */
+
+static void
+dump_combine_recog_cache (file, lookups, hits)
+     char *file;
+     int lookups, hits;
+{
+  fprintf (file, ";; Recognition cache: %d lookups, %d hits (%d%%).\n",
+	   lookups, hits, lookups ? hits * 100 / lookups : 0);
+}
+
 dump_combine_stats (file)
      char *file;
 {
   fprintf
     (file,
-     ";; Combiner statistics: %d attempts, %d substitutions (%d requiring new space),\n;; %d successes.\n\n"
-     , combine_attempts, combine_merges, combine_extras, combine_successes);
+     ";; Combiner statistics: %d attempts, %d substitutions (%d requiring new space),\n;; %d successes (%d across calls).\n"
+     , combine_attempts, combine_merges, combine_extras, combine_successes,
+     combine_call_successes);
+  dump_combine_failures (file, combine_failures, combine_repeats);
+  dump_combine_recog_cache (file, combine_recog_lookups, combine_recog_hits);
+  fprintf (file, "\n");
 }
 
 dump_combine_total_stats (file)
@@ -1554,6 +1992,9 @@ dump_combine_total_stats (file)
 {
   fprintf
     (file,
-     "\n;; Combiner totals: %d attempts, %d substitutions (%d requiring new space),\n;; %d successes.\n",
-     total_attempts, total_merges, total_extras, total_successes);
+     "\n;; Combiner totals: %d attempts, %d substitutions (%d requiring new space),\n;; %d successes (%d across calls).\n",
+     total_attempts, total_merges, total_extras, total_successes,
+     total_call_successes);
+  dump_combine_failures (file, total_failures, total_repeats);
+  dump_combine_recog_cache (file, total_recog_lookups, total_recog_hits);
 }
@@ -354,10 +354,12 @@ static rtx get_related_value ();
 static void note_mem_written ();
 
 /* Return an estimate of the cost of computing rtx X.
-   The only use of this is to compare the costs of two expressions
-   to decide whether to replace one with the other.  */
+   One use of this is to compare the costs of two expressions
+   to decide whether to replace one with the other.
+   expand_mult also uses it to choose between a multiply insn
+   and a sequence of shifts and adds.  */
 
-static int
+int
 rtx_cost (x)
      rtx x;
 {
@@ -373,6 +375,9 @@ rtx_cost (x)
     case SUBREG:
       return 2;
     CONST_COSTS (x, code);
+#ifdef RTX_COSTS
+    RTX_COSTS (x, code);
+#endif
     }
 
   total = 2;
@@ -731,6 +731,287 @@ expand_bit_and (mode, op0, op1, target)
   return temp;
 }
 
+/* Multiplication by a constant.
+
+   A multiplication by a constant integer is done with shifts, adds and
+   subtracts when they cost less than the multiply insn or library call.
+   The cheapest way to multiply by a constant T is found by a search
+   over these ways of reducing T to a smaller constant:
+
+   T even: multiply by T / 2**M, then shift left M bits;
+   T odd: multiply by T - 1, then add the multiplicand;
+   or multiply by T + 1, then subtract the multiplicand;
+   T a multiple of 2**M + 1: multiply by T / (2**M + 1) giving X,
+   then compute X + (X << M); likewise with 2**M - 1 and (X << M) - X;
+   T negative: multiply by - T, then negate.
+
+   Costs come from `rtx_cost', so they reflect the target's
+   RTX_COSTS and CONST_COSTS.  The best way for each constant
+   and mode is remembered in a hash table for the whole compilation,
+   since the same constants recur, and since the search for one
+   constant visits the smaller constants it can be reduced to.  */
+
+/* The ways of reducing a constant, as described above.  */
+
+enum mult_op { MULT_ONE, MULT_SHIFT, MULT_ADD, MULT_SUB,
+	       MULT_ADD_FACTOR, MULT_SUB_FACTOR, MULT_NEG };
+
+/* An entry in the table of the best ways to multiply by constants.
+   VALUE is the constant, taken modulo 2**(bits in MODE);
+   COST is the total cost of the operations; OP and LOG say what
+   the last operation is, LOG being the shift count M.  */
+
+struct mult_way
+{
+  unsigned value;
+  char mode;
+  char op;
+  char log;
+  char valid;
+  int cost;
+};
+
+/* The hash table of `struct mult_way', and its size (a power of 2).  */
+
+static struct mult_way *mult_ways;
+static int mult_ways_size;
+
+/* Number of entries in use in `mult_ways'.  */
+
+static int mult_ways_used;
+
+#define MULT_WAYS_INITIAL_SIZE 64
+
+/* The costs of the operations, for each mode in which they are used.
+   They are computed when the mode is first used.  */
+
+static char mult_costs_known[NUM_MACHINE_MODE];
+static int mult_shift_cost[NUM_MACHINE_MODE][BITS_PER_WORD];
+static int mult_add_cost[NUM_MACHINE_MODE];
+static int mult_sub_cost[NUM_MACHINE_MODE];
+static int mult_neg_cost[NUM_MACHINE_MODE];
+
+extern int rtx_cost ();
+extern int xmalloc ();
+extern void free ();
+
+static int mult_way_cost ();
+static struct mult_way *mult_way_slot ();
+static rtx expand_mult_way ();
+static void init_mult_ways ();
+
+/* Compute the costs of the operations used to multiply in MODE.  */
+
+static void
+init_mult_costs (mode)
+     enum machine_mode mode;
+{
+  rtx reg = gen_rtx (REG, mode, FIRST_PSEUDO_REGISTER);
+  register int m;
+
+  for (m = 1; m < GET_MODE_BITSIZE (mode); m++)
+    mult_shift_cost[(int) mode][m]
+      = rtx_cost (gen_rtx (ASHIFT, mode, reg,
+			   gen_rtx (CONST_INT, VOIDmode, m)));
+  mult_add_cost[(int) mode] = rtx_cost (gen_rtx (PLUS, mode, reg, reg));
+  mult_sub_cost[(int) mode] = rtx_cost (gen_rtx (MINUS, mode, reg, reg));
+  mult_neg_cost[(int) mode] = rtx_cost (gen_rtx (NEG, mode, reg));
+  mult_costs_known[(int) mode] = 1;
+}
+
+/* Get ready to look up constants for MODE in `mult_ways'.  */
+
+static void
+init_mult_ways (mode)
+     enum machine_mode mode;
+{
+  if (! mult_costs_known[(int) mode])
+    init_mult_costs (mode);
+  if (mult_ways == 0)
+    {
+      mult_ways_size = MULT_WAYS_INITIAL_SIZE;
+      mult_ways = (struct mult_way *)
+	xmalloc (mult_ways_size * sizeof (struct mult_way));
+      bzero (mult_ways, mult_ways_size * sizeof (struct mult_way));
+    }
+}
+
+/* Return the entry for constant VALUE in MODE in `mult_ways',
+   or an empty entry where it may be put.  */
+
+static struct mult_way *
+mult_way_slot (value, mode)
+     unsigned value;
+     enum machine_mode mode;
+{
+  register int i = (value * 31 + (int) mode) & (mult_ways_size - 1);
+
+  while (mult_ways[i].valid
+	 && (mult_ways[i].value != value || mult_ways[i].mode != (int) mode))
+    i = (i + 1) & (mult_ways_size - 1);
+  return &mult_ways[i];
+}
+
+/* Return the least cost of multiplying by VALUE in MODE, where VALUE
+   is nonzero and has no bits beyond those of MODE, recording the
+   best way to do it in `mult_ways'.  */
+
+static int
+mult_way_cost (value, mode)
+     register unsigned value;
+     enum machine_mode mode;
+{
+  register struct mult_way *slot;
+  int bits = GET_MODE_BITSIZE (mode);
+  unsigned mask = (bits < 32 ? (1 << bits) - 1 : ~0);
+  int best_cost, best_op, best_log = 0;
+  register int m, cost;
+  unsigned d;
+
+  slot = mult_way_slot (value, mode);
+  if (slot->valid)
+    return slot->cost;
+
+  if (value == 1)
+    {
+      best_cost = 0;
+      best_op = (int) MULT_ONE;
+    }
+  else if ((value & 1) == 0)
+    {
+      for (m = 0; (value & ((unsigned) 1 << m)) == 0; m++);
+      best_cost = (mult_way_cost (value >> m, mode)
+		   + mult_shift_cost[(int) mode][m]);
+      best_op = (int) MULT_SHIFT;
+      best_log = m;
+    }
+  else
+    {
+      best_cost = mult_way_cost (value - 1, mode) + mult_add_cost[(int) mode];
+      best_op = (int) MULT_ADD;
+
+      if (value != mask)
+	{
+	  cost = (mult_way_cost (value + 1, mode)
+		  + mult_sub_cost[(int) mode]);
+	  if (cost < best_cost)
+	    best_cost = cost, best_op = (int) MULT_SUB;
+	}
+
+      for (m = 1; m < bits - 1; m++)
+	{
+	  d = ((unsigned) 1 << m) + 1;
+	  if (d >= value)
+	    break;
+	  if (value % d == 0)
+	    {
+	      cost = (mult_way_cost (value / d, mode)
+		      + mult_shift_cost[(int) mode][m]
+		      + mult_add_cost[(int) mode]);
+	      if (cost < best_cost)
+		best_cost = cost, best_op = (int) MULT_ADD_FACTOR, best_log = m;
+	    }
+	  d = ((unsigned) 1 << (m + 1)) - 1;
+	  if (value % d == 0 && d < value)
+	    {
+	      cost = (mult_way_cost (value / d, mode)
+		      + mult_shift_cost[(int) mode][m + 1]
+		      + mult_sub_cost[(int) mode]);
+	      if (cost < best_cost)
+		best_cost = cost, best_op = (int) MULT_SUB_FACTOR,
+		best_log = m + 1;
+	    }
+	}
+
+      /* A negative odd constant.  */
+      if (value & ((unsigned) 1 << (bits - 1)))
+	{
+	  cost = (mult_way_cost ((- value) & mask, mode)
+		  + mult_neg_cost[(int) mode]);
+	  if (cost < best_cost)
+	    best_cost = cost, best_op = (int) MULT_NEG;
+	}
+    }
+
+  /* Make room in the table if necessary; the searches above may
+     have added entries, so look up the slot again.  */
+  if (4 * (mult_ways_used + 1) > 3 * mult_ways_size)
+    {
+      struct mult_way *old = mult_ways;
+      int old_size = mult_ways_size;
+      register int i;
+
+      mult_ways_size *= 2;
+      mult_ways = (struct mult_way *)
+	xmalloc (mult_ways_size * sizeof (struct mult_way));
+      bzero (mult_ways, mult_ways_size * sizeof (struct mult_way));
+      for (i = 0; i < old_size; i++)
+	if (old[i].valid)
+	  *mult_way_slot (old[i].value, (enum machine_mode) old[i].mode)
+	    = old[i];
+      free (old);
+    }
+
+  slot = mult_way_slot (value, mode);
+  slot->value = value;
+  slot->mode = (int) mode;
+  slot->op = best_op;
+  slot->log = best_log;
+  slot->cost = best_cost;
+  slot->valid = 1;
+  mult_ways_used++;
+  return best_cost;
+}
+
+/* Emit insns to multiply OP0, a register, by VALUE in MODE, in the way
+   recorded in `mult_ways', and return an rtx for the result.  */
+
+static rtx
+expand_mult_way (mode, op0, value)
+     enum machine_mode mode;
+     rtx op0;
+     unsigned value;
+{
+  struct mult_way *slot = mult_way_slot (value, mode);
+  int bits = GET_MODE_BITSIZE (mode);
+  unsigned mask = (bits < 32 ? (1 << bits) - 1 : ~0);
+  int log = slot->log;
+  rtx x, tem;
+
+  switch ((enum mult_op) slot->op)
+    {
+    case MULT_ONE:
+      return op0;
+
+    case MULT_SHIFT:
+      x = expand_mult_way (mode, op0, value >> log);
+      return expand_shift (LSHIFT_EXPR, mode, x, build_int_2 (log, 0), 0, 0);
+
+    case MULT_ADD:
+      x = expand_mult_way (mode, op0, value - 1);
+      return expand_binop (mode, add_optab, x, op0, 0, 0, OPTAB_LIB_WIDEN);
+
+    case MULT_SUB:
+      x = expand_mult_way (mode, op0, value + 1);
+      return expand_binop (mode, sub_optab, x, op0, 0, 0, OPTAB_LIB_WIDEN);
+
+    case MULT_ADD_FACTOR:
+      x = expand_mult_way (mode, op0, value / (((unsigned) 1 << log) + 1));
+      tem = expand_shift (LSHIFT_EXPR, mode, x, build_int_2 (log, 0), 0, 0);
+      return expand_binop (mode, add_optab, tem, x, 0, 0, OPTAB_LIB_WIDEN);
+
+    case MULT_SUB_FACTOR:
+      x = expand_mult_way (mode, op0, value / (((unsigned) 1 << log) - 1));
+      tem = expand_shift (LSHIFT_EXPR, mode, x, build_int_2 (log, 0), 0, 0);
+      return expand_binop (mode, sub_optab, tem, x, 0, 0, OPTAB_LIB_WIDEN);
+
+    case MULT_NEG:
+      x = expand_mult_way (mode, op0, (- value) & mask);
+      return expand_unop (mode, neg_optab, x, 0, 0);
+    }
+  abort ();
+}
+
 /* Perform a multiplication and return an rtx for the result.
    MODE is mode of value; OP0 and OP1 are what to multiply (rtx's);
    TARGET is a suggestion for where to store the result (an rtx).
@@ -745,30 +1026,31 @@ expand_mult (mode, op0, op1, target, unsignedp)
      register rtx op0, op1, target;
      int unsignedp;
 {
-  if (GET_CODE (op1) == CONST_INT)
+  if (GET_CODE (op1) == CONST_INT
+      && (mode == QImode || mode == HImode || mode == SImode)
+      && GET_MODE_BITSIZE (mode) <= BITS_PER_WORD)
     {
-      register int foo = exact_log2 (INTVAL (op1));
-      int bar;
-      /* Is multiplier a power of 2?  */
-      if (foo >= 0)
-	{
-	  return expand_shift (LSHIFT_EXPR, mode, op0,
-			       build_int_2 (foo, 0),
-			       target, 0);
-	}
-      /* Is multiplier a sum of two powers of 2?  */
-      bar = floor_log2 (INTVAL (op1));
-      foo = exact_log2 (INTVAL (op1) - (1 << bar));
-      if (bar >= 0 && foo >= 0)
+      int bits = GET_MODE_BITSIZE (mode);
+      unsigned mask = (bits < 32 ? (1 << bits) - 1 : ~0);
+      unsigned value = INTVAL (op1) & mask;
+
+      if (value != 0)
 	{
-	  rtx pow1 = ((foo == 0) ? op0
-		      : expand_shift (LSHIFT_EXPR, mode, op0,
-				      build_int_2 (foo, 0),
-				      0, 0));
-	  rtx pow2 = expand_shift (LSHIFT_EXPR, mode, op0,
-				   build_int_2 (bar, 0),
-				   0, 0);
-	  return force_operand (gen_rtx (PLUS, mode, pow1, pow2), target);
+	  int cost;
+
+	  init_mult_ways (mode);
+	  cost = mult_way_cost (value, mode);
+	  if (cost <= rtx_cost (gen_rtx (MULT, mode,
+					gen_rtx (REG, mode,
+						 FIRST_PSEUDO_REGISTER),
+					op1)))
+	    {
+	      /* OP0 is used more than once, so it must be in a register.  */
+	      op0 = protect_from_queue (op0, 0);
+	      if (GET_CODE (op0) != REG)
+		op0 = copy_to_reg (op0);
+	      return expand_mult_way (mode, op0, value);
+	    }
 	}
     }
   op0 = expand_binop (mode, unsignedp ? umul_optab : smul_optab,
@@ -778,6 +1060,394 @@ expand_mult (mode, op0, op1, target, unsignedp)
   return op0;
 }
 
+/* Division by a constant D that is not a power of 2 is done by
+   multiplying by an approximation of 2**(32+S) / D, taking the high
+   32 bits of the 64-bit product, and shifting those right S more bits.
+   The multiplier is chosen, as described by Granlund and Montgomery,
+   so that the quotient is exact for every dividend.  The remainder
+   is then the dividend minus the quotient times D.
+
+   Only the high half of the product is wanted.  A widening multiply
+   (`mulsidi3' or `umulsidi3') yields it directly.  Otherwise it is
+   pieced together from the four products of 16-bit halves, using a
+   `umulhisi3' insn if there is one, else multiplying by each half of
+   the constant in SImode, which `expand_mult' may do with shifts
+   and adds.  All this is done only when it costs less than the divide,
+   according to `rtx_cost'.  */
+
+/* The ways of getting the high half of a product.  */
+
+#define DIVIDE_WIDEN_DI 0	/* Widening multiply to DImode.  */
+#define DIVIDE_WIDEN_SI 1	/* Widening multiplies of halves to SImode.  */
+#define DIVIDE_HALVES 2		/* SImode multiplies of halves.  */
+
+/* Compute the multiplier for unsigned division by D.  Store it in
+   *MULTIPLIER, and the shift count in *SHIFT.  Store 1 in *ADD if the
+   true multiplier is 2**32 plus the stored one, so that the dividend
+   must be added back in.  */
+
+static void
+unsigned_divide_magic (d, multiplier, add, shift)
+     unsigned d;
+     unsigned *multiplier;
+     int *add, *shift;
+{
+  unsigned q, r, delta, p32 = 0;
+  int p = 31;
+
+  *add = 0;
+  q = 0x7fffffff / d;
+  r = 0x7fffffff - q * d;
+  do
+    {
+      p++;
+      p32 = (p == 32 ? 1 : 2 * p32);
+      if (r + 1 >= d - r)
+	{
+	  if (q >= 0x7fffffff)
+	    *add = 1;
+	  q = 2 * q + 1;
+	  r = 2 * r + 1 - d;
+	}
+      else
+	{
+	  if (q >= 0x80000000)
+	    *add = 1;
+	  q = 2 * q;
+	  r = 2 * r + 1;
+	}
+      delta = d - 1 - r;
+    }
+  while (p < 64 && p32 < delta);
+
+  *multiplier = q + 1;
+  *shift = p - 32;
+}
+
+/* Compute the multiplier for signed division by D, which is not
+   0, 1, -1 or the most negative number.  Store it in *MULTIPLIER,
+   and the shift count in *SHIFT.  */
+
+static void
+signed_divide_magic (d, multiplier, shift)
+     int d;
+     unsigned *multiplier;
+     int *shift;
+{
+  unsigned ad = (d < 0 ? - d : d);
+  unsigned t = 0x80000000 + ((unsigned) d >> 31);
+  unsigned anc = t - 1 - t % ad;
+  unsigned q1, r1, q2, r2, delta;
+  int p = 31;
+
+  q1 = 0x80000000 / anc;
+  r1 = 0x80000000 - q1 * anc;
+  q2 = 0x80000000 / ad;
+  r2 = 0x80000000 - q2 * ad;
+  do
+    {
+      p++;
+      q1 = 2 * q1;
+      r1 = 2 * r1;
+      if (r1 >= anc)
+	q1++, r1 -= anc;
+      q2 = 2 * q2;
+      r2 = 2 * r2;
+      if (r2 >= ad)
+	q2++, r2 -= ad;
+      delta = ad - r2;
+    }
+  while (q1 < delta || (q1 == delta && r1 == 0));
+
+  *multiplier = (d < 0 ? - (q2 + 1) : q2 + 1);
+  *shift = p - 32;
+}
+
+/* Return the cost of multiplying a register by VALUE, a nonzero
+   constant, in MODE, the cheaper way.  */
+
+static int
+const_mult_cost (mode, value)
+     enum machine_mode mode;
+     unsigned value;
+{
+  int cost;
+  int insn_cost
+    = rtx_cost (gen_rtx (MULT, mode, gen_rtx (REG, mode, FIRST_PSEUDO_REGISTER),
+			 gen_rtx (CONST_INT, VOIDmode, value)));
+
+  init_mult_ways (mode);
+  cost = mult_way_cost (value, mode);
+  return cost < insn_cost ? cost : insn_cost;
+}
+
+/* Return the cost of getting the high half of a register times VALUE,
+   signed or unsigned according to UNSIGNEDP, by METHOD.  */
+
+static int
+mult_high_cost (value, unsignedp, method)
+     unsigned value;
+     int unsignedp;
+     int method;
+{
+  rtx reg = gen_rtx (REG, SImode, FIRST_PSEUDO_REGISTER);
+  int add = mult_add_cost[(int) SImode];
+  unsigned low = value & 0xffff, high = value >> 16;
+  int cost;
+  int product_unsignedp = 1;
+
+  if (method == DIVIDE_WIDEN_DI)
+    {
+      product_unsignedp
+	= (unsignedp
+	   ? umul_widen_optab[(int) DImode].insn_code != CODE_FOR_nothing
+	   : smul_widen_optab[(int) DImode].insn_code == CODE_FOR_nothing);
+      cost = rtx_cost (gen_rtx (MULT, SImode, reg,
+				gen_rtx (CONST_INT, VOIDmode, value)));
+    }
+  else
+    {
+      /* Two masks, four shifts and four adds besides the products.  */
+      cost = (2 * rtx_cost (gen_rtx (AND, SImode, reg,
+				     gen_rtx (CONST_INT, VOIDmode, 0xffff)))
+	      + 4 * rtx_cost (gen_rtx (LSHIFTRT, SImode, reg,
+				       gen_rtx (CONST_INT, VOIDmode, 16)))
+	      + 4 * add);
+      if (method == DIVIDE_WIDEN_SI)
+	{
+	  rtx hreg = gen_rtx (REG, HImode, FIRST_PSEUDO_REGISTER);
+	  cost += 2 * (rtx_cost (gen_rtx (MULT, HImode, hreg,
+					  gen_rtx (CONST_INT, VOIDmode, low)))
+		       + rtx_cost (gen_rtx (MULT, HImode, hreg,
+					    gen_rtx (CONST_INT, VOIDmode,
+						     high))));
+	}
+      else
+	cost += 2 * ((low ? const_mult_cost (SImode, low) : 0)
+		     + (high ? const_mult_cost (SImode, high) : 0));
+    }
+
+  /* Converting between the signed and unsigned high halves.  */
+  if (product_unsignedp != unsignedp)
+    {
+      cost += (rtx_cost (gen_rtx (ASHIFTRT, SImode, reg,
+				  gen_rtx (CONST_INT, VOIDmode, 31)))
+	       + rtx_cost (gen_rtx (AND, SImode, reg,
+				    gen_rtx (CONST_INT, VOIDmode, value)))
+	       + add);
+      if (value & 0x80000000)
+	cost += add;
+    }
+  return cost;
+}
+
+/* Multiply OP0, an SImode register, by the 16-bit constant VALUE,
+   giving an SImode product, for the high half computed by METHOD.  */
+
+static rtx
+mult_high_part (op0, value, method)
+     rtx op0;
+     unsigned value;
+     int method;
+{
+  rtx c = gen_rtx (CONST_INT, VOIDmode, value);
+  rtx temp;
+
+  if (value == 0)
+    return const0_rtx;
+  if (method == DIVIDE_HALVES)
+    return expand_mult (SImode, op0, c, 0, 1);
+  temp = expand_binop (SImode, umul_widen_optab, op0, c, 0, 1, OPTAB_DIRECT);
+  if (temp == 0)
+    abort ();
+  return temp;
+}
+
+/* Emit insns to get the high half of OP0, an SImode register,
+   times VALUE by METHOD, signed or unsigned according to UNSIGNEDP.
+   Return an rtx for the result.  */
+
+static rtx
+expand_mult_high (op0, value, unsignedp, method)
+     rtx op0;
+     unsigned value;
+     int unsignedp;
+     int method;
+{
+  rtx c = gen_rtx (CONST_INT, VOIDmode, value);
+  tree sixteen = build_int_2 (16, 0);
+  rtx mask = gen_rtx (CONST_INT, VOIDmode, 0xffff);
+  struct optab *adjust;
+  rtx high, temp;
+  int product_unsignedp = 1;
+
+  if (method == DIVIDE_WIDEN_DI)
+    {
+      product_unsignedp
+	= (unsignedp
+	   ? umul_widen_optab[(int) DImode].insn_code != CODE_FOR_nothing
+	   : smul_widen_optab[(int) DImode].insn_code == CODE_FOR_nothing);
+      temp = expand_binop (DImode,
+			   product_unsignedp ? umul_widen_optab : smul_widen_optab,
+			   op0, c, 0, product_unsignedp, OPTAB_DIRECT);
+      if (temp == 0)
+	abort ();
+      high = gen_highpart (SImode, temp);
+    }
+  else
+    {
+      /* Add up the products of the 16-bit halves, carrying from
+	 the low half of each sum into the next.  */
+      rtx op0_low = expand_bit_and (SImode, op0, mask, 0);
+      rtx op0_high = expand_shift (RSHIFT_EXPR, SImode, op0, sixteen, 0, 1);
+      unsigned low = value & 0xffff, high_value = value >> 16;
+      rtx t, t_low, t_high;
+
+      temp = mult_high_part (op0_low, low, method);
+      temp = expand_shift (RSHIFT_EXPR, SImode, temp, sixteen, 0, 1);
+      t = expand_binop (SImode, add_optab,
+			mult_high_part (op0_high, low, method), temp,
+			0, 1, OPTAB_LIB_WIDEN);
+      t_low = expand_bit_and (SImode, t, mask, 0);
+      t_high = expand_shift (RSHIFT_EXPR, SImode, t, sixteen, 0, 1);
+      t_low = expand_binop (SImode, add_optab,
+			    mult_high_part (op0_low, high_value, method), t_low,
+			    0, 1, OPTAB_LIB_WIDEN);
+      temp = expand_binop (SImode, add_optab,
+			   mult_high_part (op0_high, high_value, method), t_high,
+			   0, 1, OPTAB_LIB_WIDEN);
+      high = expand_binop (SImode, add_optab, temp,
+			   expand_shift (RSHIFT_EXPR, SImode, t_low,
+					 sixteen, 0, 1),
+			   0, 1, OPTAB_LIB_WIDEN);
+    }
+
+  /* The unsigned high half exceeds the signed one by VALUE if OP0
+     is negative, and by OP0 if VALUE is.  */
+  if (product_unsignedp != unsignedp)
+    {
+      adjust = unsignedp ? add_optab : sub_optab;
+      temp = expand_shift (RSHIFT_EXPR, SImode, op0, build_int_2 (31, 0),
+			   0, 0);
+      temp = expand_bit_and (SImode, temp, c, 0);
+      high = expand_binop (SImode, adjust, high, temp,
+			   0, 1, OPTAB_LIB_WIDEN);
+      if (value & 0x80000000)
+	high = expand_binop (SImode, adjust, high, op0,
+			     0, 1, OPTAB_LIB_WIDEN);
+    }
+  return high;
+}
+
+/* Try to divide OP0 by OP1, a CONST_INT, in SImode with truncation,
+   by multiplying as described above.  Return an rtx for the quotient,
+   or for the remainder if REM_FLAG, or 0 if the divide is cheaper.  */
+
+static rtx
+expand_divide_by_constant (rem_flag, op0, op1, target, unsignedp)
+     int rem_flag;
+     rtx op0, op1, target;
+     int unsignedp;
+{
+  rtx reg = gen_rtx (REG, SImode, FIRST_PSEUDO_REGISTER);
+  int d = INTVAL (op1);
+  unsigned multiplier;
+  int add = 0, shift;
+  int method, cost, best_cost, add_cost, shift_cost;
+  rtx quotient, temp;
+
+  if (d == 0 || (! unsignedp && (d == 1 || d == -1 || d == 0x80000000)))
+    return 0;
+
+  if (unsignedp)
+    unsigned_divide_magic ((unsigned) d, &multiplier, &add, &shift);
+  else
+    signed_divide_magic (d, &multiplier, &shift);
+
+  init_mult_ways (SImode);
+  add_cost = mult_add_cost[(int) SImode];
+  shift_cost = rtx_cost (gen_rtx (LSHIFTRT, SImode, reg,
+				  gen_rtx (CONST_INT, VOIDmode, shift)));
+
+  /* Choose the cheapest way to get the high half of the product.  */
+  if (smul_widen_optab[(int) DImode].insn_code != CODE_FOR_nothing
+      || umul_widen_optab[(int) DImode].insn_code != CODE_FOR_nothing)
+    method = DIVIDE_WIDEN_DI;
+  else
+    method = DIVIDE_HALVES;
+  best_cost = mult_high_cost (multiplier, unsignedp, method);
+  if (method == DIVIDE_HALVES
+      && umul_widen_optab[(int) SImode].insn_code != CODE_FOR_nothing)
+    {
+      cost = mult_high_cost (multiplier, unsignedp, DIVIDE_WIDEN_SI);
+      if (cost < best_cost)
+	best_cost = cost, method = DIVIDE_WIDEN_SI;
+    }
+
+  /* Add the cost of the rest of the sequence.  */
+  cost = best_cost;
+  if (unsignedp)
+    cost += shift_cost + (add ? 2 * add_cost + shift_cost : 0);
+  else
+    cost += 2 * shift_cost + add_cost
+      + (d > 0 ? (int) multiplier < 0 : (int) multiplier > 0) * add_cost;
+  if (rem_flag)
+    cost += const_mult_cost (SImode, (unsigned) d) + add_cost;
+
+  if (cost >= rtx_cost (gen_rtx (rem_flag ? (unsignedp ? UMOD : MOD)
+				 : (unsignedp ? UDIV : DIV),
+				 SImode, reg, op1)))
+    return 0;
+
+  /* OP0 is used more than once, so it must be in a register.  */
+  op0 = protect_from_queue (op0, 0);
+  if (GET_CODE (op0) != REG)
+    op0 = copy_to_reg (op0);
+
+  quotient = expand_mult_high (op0, multiplier, unsignedp, method);
+  if (unsignedp)
+    {
+      if (add)
+	{
+	  temp = expand_binop (SImode, sub_optab, op0, quotient,
+			       0, 1, OPTAB_LIB_WIDEN);
+	  temp = expand_shift (RSHIFT_EXPR, SImode, temp,
+			       build_int_2 (1, 0), 0, 1);
+	  quotient = expand_binop (SImode, add_optab, temp, quotient,
+				   0, 1, OPTAB_LIB_WIDEN);
+	  shift--;
+	}
+      if (shift > 0)
+	quotient = expand_shift (RSHIFT_EXPR, SImode, quotient,
+				 build_int_2 (shift, 0),
+				 rem_flag ? 0 : target, 1);
+    }
+  else
+    {
+      if (d > 0 && (int) multiplier < 0)
+	quotient = expand_binop (SImode, add_optab, quotient, op0,
+				 0, 0, OPTAB_LIB_WIDEN);
+      else if (d < 0 && (int) multiplier > 0)
+	quotient = expand_binop (SImode, sub_optab, quotient, op0,
+				 0, 0, OPTAB_LIB_WIDEN);
+      if (shift > 0)
+	quotient = expand_shift (RSHIFT_EXPR, SImode, quotient,
+				 build_int_2 (shift, 0), 0, 0);
+      /* Round a negative quotient toward zero by adding 1.  */
+      temp = expand_shift (RSHIFT_EXPR, SImode, quotient,
+			   build_int_2 (31, 0), 0, 1);
+      quotient = expand_binop (SImode, add_optab, quotient, temp,
+			       rem_flag ? 0 : target, 0, OPTAB_LIB_WIDEN);
+    }
+
+  if (! rem_flag)
+    return quotient;
+
+  temp = expand_mult (SImode, quotient, op1, 0, unsignedp);
+  return expand_binop (SImode, sub_optab, op0, temp, target,
+		       unsignedp, OPTAB_LIB_WIDEN);
+}
+
 /* Emit the code to divide OP0 by OP1, putting the result in TARGET
    if that is convenient, and returning where the result is.
    You may request either the quotient or the remainder as the result;
@@ -818,6 +1488,16 @@ expand_divmod (rem_flag, code, mode, op0, op1, target, unsignedp)
   if (GET_CODE (op1) == CONST_INT)
     log = exact_log2 (INTVAL (op1));
 
+  /* Division by other constants can be done by multiplication.  */
+  if ((code == TRUNC_DIV_EXPR || code == TRUNC_MOD_EXPR)
+      && GET_CODE (op1) == CONST_INT && log < 0
+      && mode == SImode && GET_MODE_BITSIZE (SImode) == 32)
+    {
+      temp = expand_divide_by_constant (rem_flag, op0, op1, target, unsignedp);
+      if (temp != 0)
+	return temp;
+    }
+
   /* If log is >= 0, we are dividing by 2**log, and will do it by shifting,
      which is really floor-division.  Otherwise we will really do a divide,
      and we assume that is trunc-division.
@@ -57,15 +57,37 @@ static rtx compare ();
 static rtx compare1 ();
 static rtx do_store_flag ();
 static void preexpand_calls ();
+static enum machine_mode block_move_mode ();
+static void move_by_loop ();
+static void clear_storage ();
+static int zero_constructor_p ();
 
 /* MOVE_RATIO is the number of move instructions that is better than
    a block move.  */
 
+#ifndef MOVE_RATIO
 #if defined (HAVE_movstrhi) || defined (HAVE_movstrsi)
 #define MOVE_RATIO 2
 #else
 #define MOVE_RATIO 6
 #endif
+#endif
+
+/* BLOCK_MOVE_LOOP_MAX is the largest number of bytes that is better
+   moved or cleared by a loop than by a block move or a library call.
+   BLOCK_MOVE_UNROLL is the number of moves in each iteration.  */
+
+#ifndef BLOCK_MOVE_LOOP_MAX
+#define BLOCK_MOVE_LOOP_MAX 0
+#endif
+
+#ifndef BLOCK_MOVE_UNROLL
+#define BLOCK_MOVE_UNROLL 4
+#endif
+
+/* The ways of moving or clearing a block whose size is known.  */
+
+enum block_method { BLOCK_BY_PIECES, BLOCK_BY_LOOP, BLOCK_BY_CALL };
 
 /* Table indexed by tree code giving 1 if the code is for a
    comparison operation, or anything that is most easily
@@ -484,7 +506,8 @@ convert_to_mode (mode, x, unsignedp)
     through protect_from_queue before calling.
    FROM_VOL and TO_VOL are nonzero if references to
     FROM and TO, respectively, should be marked VOLATILE.
-   ALIGN (in bytes) is maximum alignment we can assume.  */
+   ALIGN (in bytes) is maximum alignment we can assume.
+   If FROM is zero, store zeros at TO instead.  */
 
 struct move_by_pieces
 {
@@ -516,7 +539,9 @@ move_by_pieces (to, from, len, align, to_vol, from_vol)
   data.from_vol = from_vol;
   data.autinc_to = (GET_CODE (to) == PRE_INC || GET_CODE (to) == PRE_DEC
 		    || GET_CODE (to) == POST_INC || GET_CODE (to) == POST_DEC);
-  data.autinc_from = (GET_CODE (from) == PRE_INC || GET_CODE (from) == PRE_DEC
+  /* With no FROM, there is no source address to advance.  */
+  data.autinc_from = (from == 0
+		      || GET_CODE (from) == PRE_INC || GET_CODE (from) == PRE_DEC
 		      || GET_CODE (from) == POST_INC
 		      || GET_CODE (from) == POST_DEC);
 
@@ -643,7 +668,11 @@ move_by_pieces_1 (genfun, mode, data)
   while (data->len >= size)
     {
       to1 = gen_rtx (MEM, mode, add_offset (data->autinc_to, data->to));
-      from1 = gen_rtx (MEM, mode, add_offset (data->autinc_from, data->from));
+      if (data->from == 0)
+	from1 = const0_rtx;
+      else
+	from1 = gen_rtx (MEM, mode,
+			 add_offset (data->autinc_from, data->from));
 
       if (data->to_vol) to1 = gen_rtx (VOLATILE, mode, to1);
       if (data->from_vol) from1 = gen_rtx (VOLATILE, mode, from1);
@@ -673,9 +702,118 @@ move_by_pieces_1 (genfun, mode, data)
     }
 }
 
+/* Return the widest mode that `move_by_pieces' would use
+   for a block whose alignment is ALIGN bytes.  */
+
+static enum machine_mode
+block_move_mode (align)
+     int align;
+{
+#ifdef STRICT_ALIGNMENT
+  if (align > MOVE_MAX)
+    align = MOVE_MAX;
+#else
+  align = MOVE_MAX;
+#endif
+
+#ifdef HAVE_movti
+  if (HAVE_movti && align >= GET_MODE_SIZE (TImode))
+    return TImode;
+#endif
+#ifdef HAVE_movdi
+  if (HAVE_movdi && align >= GET_MODE_SIZE (DImode))
+    return DImode;
+#endif
+  if (align >= GET_MODE_SIZE (SImode))
+    return SImode;
+  if (align >= GET_MODE_SIZE (HImode))
+    return HImode;
+  return QImode;
+}
+
+/* Return the way to move or clear a block of SIZE bytes
+   whose alignment is ALIGN bytes.  */
+
+static enum block_method
+block_move_method (size, align)
+     int size, align;
+{
+  int unit = GET_MODE_SIZE (block_move_mode (align));
+
+  if (move_by_pieces_ninsns ((unsigned) size, align) < MOVE_RATIO)
+    return BLOCK_BY_PIECES;
+  if (size > BLOCK_MOVE_LOOP_MAX)
+    return BLOCK_BY_CALL;
+  /* A loop that would run only once is no shorter than the pieces.  */
+  if (size < 2 * unit * BLOCK_MOVE_UNROLL)
+    return BLOCK_BY_PIECES;
+  return BLOCK_BY_LOOP;
+}
+
+/* Generate a loop to copy LEN bytes from address FROM to address TO,
+   or to store zeros at TO if FROM is zero.  Each iteration does
+   BLOCK_MOVE_UNROLL moves in the widest mode that ALIGN permits;
+   the bytes left over are moved by pieces after the loop.
+   The arguments are as for `move_by_pieces'.  */
+
+static void
+move_by_loop (to, from, len, align, to_vol, from_vol)
+     rtx to, from;
+     int len, align;
+     int to_vol, from_vol;
+{
+  enum machine_mode mode = block_move_mode (align);
+  int size = GET_MODE_SIZE (mode);
+  int step = size * BLOCK_MOVE_UNROLL;
+  rtx label = gen_label_rtx ();
+  rtx counter, to1, from1;
+  register int i;
+
+  /* The addresses are stepped through the block, so they must be
+     in registers of their own.  */
+  to = copy_to_reg (to);
+  if (from)
+    from = copy_to_reg (from);
+  counter = copy_to_reg (gen_rtx (CONST_INT, VOIDmode, len / step));
+
+  emit_label (label);
+  for (i = 0; i < BLOCK_MOVE_UNROLL; i++)
+    {
+#ifdef HAVE_POST_INCREMENT
+      /* Flow analysis will make these into post-increments.  */
+      to1 = gen_rtx (MEM, mode, to);
+      from1 = from ? gen_rtx (MEM, mode, from) : const0_rtx;
+#else
+      to1 = gen_rtx (MEM, mode, plus_constant (to, i * size));
+      from1 = from ? gen_rtx (MEM, mode, plus_constant (from, i * size))
+	: const0_rtx;
+#endif
+      if (to_vol) to1 = gen_rtx (VOLATILE, mode, to1);
+      if (from && from_vol) from1 = gen_rtx (VOLATILE, mode, from1);
+      emit_move_insn (to1, from1);
+#ifdef HAVE_POST_INCREMENT
+      emit_insn (gen_add2_insn (to, gen_rtx (CONST_INT, VOIDmode, size)));
+      if (from)
+	emit_insn (gen_add2_insn (from, gen_rtx (CONST_INT, VOIDmode, size)));
+#endif
+    }
+#ifndef HAVE_POST_INCREMENT
+  emit_insn (gen_add2_insn (to, gen_rtx (CONST_INT, VOIDmode, step)));
+  if (from)
+    emit_insn (gen_add2_insn (from, gen_rtx (CONST_INT, VOIDmode, step)));
+#endif
+  emit_insn (gen_add2_insn (counter, gen_rtx (CONST_INT, VOIDmode, -1)));
+  emit_cmp_insn (counter, const0_rtx, 0, 0);
+  emit_jump_insn (gen_bne (label));
+
+  if (len % step)
+    move_by_pieces (to, from, len % step, align, to_vol, from_vol);
+}
+
 /* Emit code to move a block Y to a block X.
    This may be done with string-move instructions,
-   with multiple scalar move instructions, or with a library call.
+   with multiple scalar move instructions, with a loop of them,
+   or with a library call.
 
    Both X and Y must be MEM rtx's (perhaps inside VOLATILE)
    with mode BLKmode.
@@ -718,11 +856,15 @@ emit_block_move (x, y, size, align)
     abort ();
 
   if (GET_CODE (size) == CONST_INT
-      && (move_by_pieces_ninsns ((unsigned) INTVAL (size), align)
-	  < MOVE_RATIO))
+      && block_move_method (INTVAL (size), align) == BLOCK_BY_PIECES)
     move_by_pieces (XEXP (xinner, 0), XEXP (yinner, 0),
 		    INTVAL (size), align,
 		    xvolatile, yvolatile);
+  else if (GET_CODE (size) == CONST_INT
+	   && block_move_method (INTVAL (size), align) == BLOCK_BY_LOOP)
+    move_by_loop (XEXP (xinner, 0), XEXP (yinner, 0),
+		  INTVAL (size), align,
+		  xvolatile, yvolatile);
   else
     {
 #ifdef HAVE_movstrsi
@@ -749,6 +891,79 @@ emit_block_move (x, y, size, align)
     }
 }
 
+/* Emit code to store zeros in the block X, a MEM (perhaps inside
+   VOLATILE) with mode BLKmode.  SIZE and ALIGN are as for
+   `emit_block_move'.  Blocks too big for a loop are cleared
+   with a library call.  */
+
+static void
+clear_storage (x, size, align)
+     rtx x;
+     rtx size;
+     int align;
+{
+  rtx xinner;
+  int xvolatile = 0;
+
+  x = protect_from_queue (x, 1);
+  xinner = x;
+  if (GET_CODE (x) == VOLATILE)
+    xvolatile = 1, xinner = XEXP (x, 0);
+  if (GET_CODE (xinner) != MEM)
+    abort ();
+
+  if (GET_CODE (size) == CONST_INT
+      && block_move_method (INTVAL (size), align) == BLOCK_BY_PIECES)
+    move_by_pieces (XEXP (xinner, 0), 0, INTVAL (size), align, xvolatile, 0);
+  else if (GET_CODE (size) == CONST_INT
+	   && block_move_method (INTVAL (size), align) == BLOCK_BY_LOOP)
+    move_by_loop (XEXP (xinner, 0), 0, INTVAL (size), align, xvolatile, 0);
+  else
+    emit_library_call (gen_rtx (SYMBOL_REF, Pmode, "bzero"),
+		       2, XEXP (xinner, 0), Pmode,
+		       size, Pmode);
+}
+
+/* Return nonzero if EXP, a constant or a CONSTRUCTOR, is entirely zero.
+   Members a CONSTRUCTOR leaves out are zero.  */
+
+static int
+zero_constructor_p (exp)
+     tree exp;
+{
+  register tree link;
+  double zero = 0;
+
+  switch (TREE_CODE (exp))
+    {
+    case INTEGER_CST:
+      return TREE_INT_CST_LOW (exp) == 0 && TREE_INT_CST_HIGH (exp) == 0;
+
+    case REAL_CST:
+      /* -0.0 equals 0.0 but does not have all bits zero.  */
+      return ! bcmp (&TREE_REAL_CST (exp), &zero, sizeof zero);
+
+    case NOP_EXPR:
+    case CONVERT_EXPR:
+    case FLOAT_EXPR:
+      /* Members' initializers are converted to their types
+	 but not folded, so {0, 0} gives a double member (float) 0.  */
+      return zero_constructor_p (TREE_OPERAND (exp, 0));
+
+    case COMPLEX_CST:
+      return (zero_constructor_p (TREE_REALPART (exp))
+	      && zero_constructor_p (TREE_IMAGPART (exp)));
+
+    case CONSTRUCTOR:
+      for (link = TREE_OPERAND (exp, 0); link; link = TREE_CHAIN (link))
+	if (! zero_constructor_p (TREE_VALUE (link)))
+	  return 0;
+      return 1;
+    }
+
+  return 0;
+}
+
 /* Generate code to copy Y into X.
    Both Y and X must have the same mode, except that
    Y can be a constant with VOIDmode.
@@ -1868,6 +2083,18 @@ expand_expr (exp, target, tmode, sum_ok)
     case ENTRY_VALUE_EXPR:
       abort ();
 
+    case CONSTRUCTOR:
+      /* Only an initializer of all zeros for an automatic aggregate
+	 is handled here; it is stored in line.  */
+      if (target == 0 || ! zero_constructor_p (exp))
+	abort ();
+      if (GET_MODE (target) == BLKmode)
+	clear_storage (target, expr_size (exp),
+		       TYPE_ALIGN (TREE_TYPE (exp)) / BITS_PER_UNIT);
+      else
+	emit_move_insn (target, const0_rtx);
+      return target;
+
     case ERROR_MARK:
       return gen_rtx (CONST_INT, (mode != VOIDmode) ? mode : SImode, 0);
 
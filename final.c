@@ -52,6 +52,8 @@ and this notice must be preserved on all copies.  */
 #define min(A,B) ((A) < (B) ? (A) : (B))
 
 void output_asm_insn ();
+static void output_asm_ops ();
+static void output_asm_operand ();
 static void alter_reg ();
 static void alter_subreg ();
 static int alter_cond ();
@@ -60,6 +62,8 @@ static void output_operand ();
 static void output_address ();
 static void output_addr_reg ();
 void output_addr_const ();
+void output_decimal ();
+void output_label_number ();
 
 static char *reg_name[] = REGISTER_NAMES;
 
@@ -237,7 +241,11 @@ final (first, file, fnname, write_symbols, optimize)
 	      /* Output debugging info about the symbol-block beginning.  */
 
 	      if (write_symbols == 2)
-		fprintf (file, "LBB%d:\n", next_block_index++);
+		{
+		  fputs ("LBB", file);
+		  output_decimal (file, next_block_index++);
+		  fputs (":\n", file);
+		}
 	      else
 		fprintf (file, "\t.gdbbeg %d\n", next_block_index++);
 	    }
@@ -249,7 +257,11 @@ final (first, file, fnname, write_symbols, optimize)
 	      if (write_symbols == 2)
 		{
 		  if (depth > 0)
-		    fprintf (file, "LBE%d:\n", pending_blocks[--depth]);
+		    {
+		      fputs ("LBE", file);
+		      output_decimal (file, pending_blocks[--depth]);
+		      fputs (":\n", file);
+		    }
 		}
 	      else
 		fprintf (file, "\t.gdbend %d\n", pending_blocks[--depth]);
@@ -263,7 +275,8 @@ final (first, file, fnname, write_symbols, optimize)
 	  break;
 
 	case CODE_LABEL:
-	  fprintf (file, "L%d:\n", CODE_LABEL_NUMBER (insn));
+	  output_label_number (file, CODE_LABEL_NUMBER (insn));
+	  fputs (":\n", file);
 	  CC_STATUS_INIT;
 	  break;
 
@@ -296,8 +309,14 @@ final (first, file, fnname, write_symbols, optimize)
 		register int vlen, idx;
 		vlen = XVECLEN (body, 0);
 		for (idx = 0; idx < vlen; idx++)
-		  fprintf (file, "\t%s L%d\n", pseudo,
-			   CODE_LABEL_NUMBER (XEXP (XVECEXP (body, 0, idx), 0)));
+		  {
+		    putc ('\t', file);
+		    fputs (pseudo, file);
+		    putc (' ', file);
+		    output_label_number
+		      (file, CODE_LABEL_NUMBER (XEXP (XVECEXP (body, 0, idx), 0)));
+		    putc ('\n', file);
+		  }
 		break;
 	      }
 	    if (GET_CODE (body) == ADDR_DIFF_VEC)
@@ -308,9 +327,17 @@ final (first, file, fnname, write_symbols, optimize)
 		register int vlen, idx;
 		vlen = XVECLEN (body, 1);
 		for (idx = 0; idx < vlen; idx++)
-		  fprintf (file, "\t%s L%d-L%d\n", pseudo,
-			   CODE_LABEL_NUMBER (XEXP (XVECEXP (body, 1, idx), 0)),
-			   CODE_LABEL_NUMBER (XEXP (XEXP (body, 0), 0)));
+		  {
+		    putc ('\t', file);
+		    fputs (pseudo, file);
+		    putc (' ', file);
+		    output_label_number
+		      (file, CODE_LABEL_NUMBER (XEXP (XVECEXP (body, 1, idx), 0)));
+		    putc ('-', file);
+		    output_label_number
+		      (file, CODE_LABEL_NUMBER (XEXP (XEXP (body, 0), 0)));
+		    putc ('\n', file);
+		  }
 		break;
 	      }
 
@@ -474,9 +501,14 @@ final (first, file, fnname, write_symbols, optimize)
 	      template = output_insn_hairy (insn_code_number,
 					    recog_operand, insn);
 
-	    /* Output assembler code from the template.  */
+	    /* Output assembler code from the template.
+	       If genoutput has parsed it already, use that.  */
 
-	    output_asm_insn (template, recog_operand);
+	    if (insn_template_ops[insn_code_number] != 0)
+	      output_asm_ops (insn_template_ops[insn_code_number],
+			      recog_operand);
+	    else
+	      output_asm_insn (template, recog_operand);
 	  }
 	}
     }
@@ -504,8 +536,11 @@ output_source_line (file, insn)
 	     filename, N_SOL);
   lastfile = filename;
 
-  fprintf (file, "\t.stabd %d,0,%d\n",
-	   N_SLINE, NOTE_LINE_NUMBER (insn));
+  fputs ("\t.stabd ", file);
+  output_decimal (file, N_SLINE);
+  fputs (",0,", file);
+  output_decimal (file, NOTE_LINE_NUMBER (insn));
+  putc ('\n', file);
 }
 
 /* Replace all pseudo regs in *X with their allocated homes:
@@ -681,7 +716,12 @@ alter_cond (cond)
   return value;
 }
 
-/* Output of assembler code from a template, and its subroutines.  */
+/* Output of assembler code from a template, and its subroutines.
+
+   All assembler code goes through stdio, but this is the innermost loop
+   of the compiler's output, so it avoids `fprintf': text is written in
+   pieces with `fwrite', `fputs' and `putc', and numbers are converted
+   by `output_decimal'.  */
 
 /* Output text from TEMPLATE to the assembler output file,
    obeying %-directions to substitute operands taken from
@@ -704,63 +744,107 @@ output_asm_insn (template, operands)
      char *template;
      rtx *operands;
 {
-  register char *p;
+  register char *p, *q;
   register int c;
 
   p = template;
   putc ('\t', outfile);
-  while (c = *p++)
+  while (*p)
     {
-      if (c != '%')
-	putc (c, outfile);
-      else
+      /* Copy the text up to the next %-direction in one piece.  */
+      for (q = p; *q != 0 && *q != '%'; q++)
+	;
+      if (q != p)
+	fwrite (p, 1, q - p, outfile);
+      if (*q == 0)
+	break;
+      p = q + 1;
+
+      if (*p == 'l' || *p == 'c' || *p == 'a' || *p == 'n')
 	{
-	  if (*p == 'l')
-	    {
-	      c = atoi (++p);
-	      output_asm_label (operands[c]);
-	    }
-	  else if (*p == 'c')
-	    {
-	      c = atoi (++p);
-	      output_addr_const (outfile, operands[c]);
-	    }
-	  else if (*p == 'a')
-	    {
-	      c = atoi (++p);
-	      output_address (operands[c]);
-	    }
-	  else if (*p == 'n')
-	    {
-	      c = atoi (++p);
-	      if (GET_CODE (operands[c]) == CONST_INT)
-		fprintf (outfile, "%d", - INTVAL (operands[c]));
-	      else
-		{
-		  putc ('-', outfile);
-		  output_addr_const (operands[c]);
-		}
-	    }
-	  else
-	    {
-	      c = atoi (p);
-	      output_operand (operands[c]);
-	    }
-	  while ((c = *p) >= '0' && c <= '9') p++;
+	  c = *p++;
+	  output_asm_operand (operands[atoi (p)], c);
 	}
+      else
+	output_asm_operand (operands[atoi (p)], '%');
+      while ((c = *p) >= '0' && c <= '9') p++;
     }
 
   putc ('\n', outfile);
 }
 
+/* Output an insn from OPS, a template as parsed by genoutput
+   (see the description of `insn_template_ops' there),
+   substituting operands from the vector OPERANDS.  */
+
+static void
+output_asm_ops (ops, operands)
+     char *ops;
+     rtx *operands;
+{
+  register char *p = ops;
+  register int c;
+
+  putc ('\t', outfile);
+  while (c = *p++ & 0377)
+    {
+      if (c & 0200)
+	output_asm_operand (operands[c & 0177], *p++);
+      else
+	{
+	  fwrite (p, 1, c, outfile);
+	  p += c;
+	}
+    }
+  putc ('\n', outfile);
+}
+
+/* Output operand X as called for by the template directive `%'
+   followed by LETTER, or just `%' (and the operand number) if LETTER
+   is `%'.  */
+
+static void
+output_asm_operand (x, letter)
+     rtx x;
+     int letter;
+{
+  switch (letter)
+    {
+    case 'l':
+      output_asm_label (x);
+      break;
+
+    case 'c':
+      output_addr_const (outfile, x);
+      break;
+
+    case 'a':
+      output_address (x);
+      break;
+
+    case 'n':
+      if (GET_CODE (x) == CONST_INT)
+	output_decimal (outfile, - INTVAL (x));
+      else
+	{
+	  putc ('-', outfile);
+	  output_addr_const (outfile, x);
+	}
+      break;
+
+    default:
+      output_operand (x);
+    }
+}
+
 static void
 output_asm_label (x)
      rtx x;
 {
   if (GET_CODE (x) == LABEL_REF)
-    fprintf (outfile, "L%d", CODE_LABEL_NUMBER (XEXP (x, 0)));
+    output_label_number (outfile, CODE_LABEL_NUMBER (XEXP (x, 0)));
   else if (GET_CODE (x) == CODE_LABEL)
-    fprintf (outfile, "L%d", CODE_LABEL_NUMBER (x));
+    output_label_number (outfile, CODE_LABEL_NUMBER (x));
   else
     abort ();
 }
@@ -804,21 +888,24 @@ output_addr_const (file, x)
     {
     case SYMBOL_REF:
       if (XSTR (x, 0)[0] == '*')
-	fprintf (file, "%s", XSTR (x, 0) + 1);
+	fputs (XSTR (x, 0) + 1, file);
       else
-	fprintf (file, "_%s", XSTR (x, 0));
+	{
+	  putc ('_', file);
+	  fputs (XSTR (x, 0), file);
+	}
       break;
 
     case LABEL_REF:
-      fprintf (file, "L%d", CODE_LABEL_NUMBER (XEXP (x, 0)));
+      output_label_number (file, CODE_LABEL_NUMBER (XEXP (x, 0)));
       break;
 
     case CODE_LABEL:
-      fprintf (file, "L%d", CODE_LABEL_NUMBER (x));
+      output_label_number (file, CODE_LABEL_NUMBER (x));
       break;
 
     case CONST_INT:
-      fprintf (file, "%d", INTVAL (x));
+      output_decimal (file, INTVAL (x));
       break;
 
     case CONST:
@@ -827,13 +914,13 @@ output_addr_const (file, x)
 
     case PLUS:
       output_addr_const (file, XEXP (x, 0));
-      fprintf (file, "+");
+      putc ('+', file);
       output_addr_const (file, XEXP (x, 1));
       break;
 
     case MINUS:
       output_addr_const (file, XEXP (x, 0));
-      fprintf (file, "-");
+      putc ('-', file);
       output_addr_const (file, XEXP (x, 1));
       break;
 
@@ -841,3 +928,34 @@ output_addr_const (file, x)
       abort ();
     }
 }
+
+/* Output the integer VALUE in decimal on FILE,
+   exactly as `fprintf' would with "%d".  */
+
+void
+output_decimal (file, value)
+     FILE *file;
+     int value;
+{
+  char buf[12];
+  register char *p = buf + sizeof buf;
+  register unsigned n = value < 0 ? - (unsigned) value : value;
+
+  do
+    *--p = '0' + n % 10;
+  while (n /= 10);
+  if (value < 0)
+    *--p = '-';
+  fwrite (p, 1, buf + sizeof buf - p, file);
+}
+
+/* Output the assembler name of the internal label numbered NUM on FILE.  */
+
+void
+output_label_number (file, num)
+     FILE *file;
+     int num;
+{
+  putc ('L', file);
+  output_decimal (file, num);
+}
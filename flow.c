@@ -46,7 +46,9 @@ and this notice must be preserved on all copies.  */
 
    life_analysis is called immediately after find_basic_blocks.
    It uses the basic block information to determine where each
-   hard or pseudo register is live.
+   hard or pseudo register is live.  It keeps a queue of the blocks
+   whose live-at-end sets have grown, and rescans only those,
+   so that each block is usually scanned only once or twice.
 
    ** live-register info **
 
@@ -92,6 +94,13 @@ and this notice must be preserved on all copies.  */
 #include "rtl.h"
 #include "basic-block.h"
 #include "regs.h"
+#include "obstack.h"
+
+#define obstack_chunk_alloc xmalloc
+#define obstack_chunk_free free
+
+extern int xmalloc ();
+extern void free ();
 
 /* Get the basic block number of an insn.
    This info should not be expected to remain available
@@ -103,7 +112,7 @@ and this notice must be preserved on all copies.  */
    This is set up by find_basic_blocks and used there and in life_analysis,
    and then freed.  */
 
-static short *uid_block_number;
+static int *uid_block_number;
 
 /* Number of basic blocks in the current function.  */
 
@@ -119,26 +128,26 @@ int max_regno;
    This information remains valid for the rest of the compilation
    of the current function; it is used to control register allocation.  */
 
-short *reg_basic_block;
+int *reg_basic_block;
 
 /* Indexed by n, gives number of times (REG n) is used or set, each
    weighted by its loop-depth.
    This information remains valid for the rest of the compilation
    of the current function; it is used to control register allocation.  */
 
-short *reg_n_refs;
+int *reg_n_refs;
 
 /* Indexed by n, gives number of times (REG n) is set.
    This information remains valid for the rest of the compilation
    of the current function; it is used to control register allocation.  */
 
-short *reg_n_sets;
+int *reg_n_sets;
 
 /* Indexed by N, gives number of places register N dies.
    This information remains valid for the rest of the compilation
    of the current function; it is used to control register allocation.  */
 
-short *reg_n_deaths;
+int *reg_n_deaths;
 
 /* Indexed by N, gives 1 if that reg is live across any CALL_INSNs.
    This information remains valid for the rest of the compilation
@@ -202,12 +211,67 @@ char *block_live_static;
 
 int loop_depth;
 
+/* The predecessors of basic block N are the blocks
+   BLOCK_PREDS[BLOCK_PRED_START[N]] through BLOCK_PREDS[BLOCK_PRED_START[N+1]-1].
+   Vectors exist only during life_analysis.  */
+
+static int *block_pred_start;
+static int *block_preds;
+
+/* If the regsets life_analysis keeps for all the blocks would take
+   no more than this many bytes, each is kept as one piece.  */
+
+#ifndef MAX_DENSE_LIFE_BYTES
+#define MAX_DENSE_LIFE_BYTES 65536
+#endif
+
+/* Otherwise, each is kept in chunks of this many words,
+   leaving out the chunks that are all zero.  */
+
+#ifndef REGSET_CHUNK_WORDS
+#define REGSET_CHUNK_WORDS 8
+#endif
+
+/* Number of words in a chunk, and number of chunks in a regset,
+   for the current function.  */
+
+static int chunk_words;
+static int regset_chunks;
+
+/* Number of chunks allocated for the current function, and
+   total bytes used by life_analysis's chunked regsets.  */
+
+static int chunks_allocated;
+static int life_chunk_bytes;
+
+/* Obstack for the chunked regsets; freed at the end of life_analysis.  */
+
+static struct obstack life_obstack;
+
+/* Statistics on the convergence of life_analysis for the current function:
+   how many times a block was taken from the queue, how many times
+   a block was scanned insn by insn, and how many times a block
+   was put back on the queue after its successors changed.  */
+
+static int life_block_visits;
+static int life_block_rescans;
+static int life_block_requeues;
+
 /* Forward declarations */
 static void find_basic_blocks ();
 static void life_analysis ();
 static void mark_label_ref ();
 void allocate_for_life_analysis (); /* Used also in stupid_life_analysis */
 static void init_regset_vector ();
+static int count_block_preds ();
+static void record_block_preds ();
+static void life_order_blocks ();
+static regset **chunked_regset_vector ();
+static int chunked_regset_growth ();
+static void chunked_regset_catch_up ();
+static void chunked_regset_copy ();
+static void chunked_regset_expand ();
+static int chunked_regset_ior ();
 static void propagate_block ();
 static void mark_set_regs ();
 static void mark_used_regs ();
@@ -259,12 +323,19 @@ flow_analysis (f, nregs, file)
   basic_block_end = (rtx *) oballoc (n_basic_blocks * sizeof (rtx));
   basic_block_drops_in = (char *) alloca (n_basic_blocks);
   basic_block_loop_depth = (short *) alloca (n_basic_blocks * sizeof (short));
-  uid_block_number = (short *) alloca ((max_uid + 1) * sizeof (short));
+  uid_block_number = (int *) alloca ((max_uid + 1) * sizeof (int));
 
   find_basic_blocks (f);
   life_analysis (f, nregs);
   if (file)
-    dump_flow_info (file);
+    {
+      dump_flow_info (file);
+      fprintf (file, "\n;; Life analysis: %d blocks, %d visits, %d rescans, %d requeued.\n",
+	       n_basic_blocks, life_block_visits, life_block_rescans,
+	       life_block_requeues);
+      fprintf (file, ";; %d-word regsets kept in %d-word chunks, %d bytes.\n",
+	       regset_size, chunk_words, life_chunk_bytes);
+    }
 
   basic_block_drops_in = 0;
   uid_block_number = 0;
@@ -482,23 +553,30 @@ life_analysis (f, nregs)
      rtx f;
      int nregs;
 {
-  register regset tem;
-  int first_pass;
-  int changed;
-  /* For each basic block, a bitmask of regs
+  /* For each basic block, a chunked regset of regs
      live on exit from the block.  */
-  regset *basic_block_live_at_end;
-  /* For each basic block, a bitmask of regs
+  regset **basic_block_live_at_end;
+  /* For each basic block, a chunked regset of regs
      live on entry to a successor-block of this block.
      If this does not match basic_block_live_at_end,
      that must be updated, and the block must be rescanned.  */
-  regset *basic_block_new_live_at_end;
-  /* For each basic block, a bitmask of regs
+  regset **basic_block_new_live_at_end;
+  /* For each basic block, a chunked regset of regs
      whose liveness at the end of the basic block
      can make a difference in which regs are live on entry to the block.
      These are the regs that are set within the basic block,
      possibly excluding those that are used after they are set.  */
-  regset *basic_block_significant;
+  regset **basic_block_significant;
+  /* An ordinary regset used while a block is scanned.  */
+  regset scratch;
+  /* Circular queue of blocks waiting to be looked at;
+     QUEUE_LENGTH of them, starting at BLOCK_QUEUE[QUEUE_HEAD].  */
+  int *block_queue;
+  int queue_head, queue_length;
+  /* For each block, nonzero if it is now in the queue.  */
+  char *block_queued;
+  /* For each block, nonzero if it has been scanned at least once.  */
+  char *block_seen;
   register int i;
 
   max_regno = nregs;
@@ -514,22 +592,25 @@ life_analysis (f, nregs)
   bzero (reg_next_use, nregs * sizeof (rtx));
 
   /* Set up several regset-vectors used internally within this function.
-     Their meanings are documented above, with their declarations.  */
-
-  basic_block_live_at_end = (regset *) alloca (n_basic_blocks * sizeof (regset));
-  tem = (regset) alloca (n_basic_blocks * regset_bytes);
-  bzero (tem, n_basic_blocks * regset_bytes);
-  init_regset_vector (basic_block_live_at_end, tem, n_basic_blocks, regset_bytes);
-
-  basic_block_new_live_at_end = (regset *) alloca (n_basic_blocks * sizeof (regset));
-  tem = (regset) alloca (n_basic_blocks * regset_bytes);
-  bzero (tem, n_basic_blocks * regset_bytes);
-  init_regset_vector (basic_block_new_live_at_end, tem, n_basic_blocks, regset_bytes);
-
-  basic_block_significant = (regset *) alloca (n_basic_blocks * sizeof (regset));
-  tem = (regset) alloca (n_basic_blocks * regset_bytes);
-  bzero (tem, n_basic_blocks * regset_bytes);
-  init_regset_vector (basic_block_significant, tem, n_basic_blocks, regset_bytes);
+     Their meanings are documented above, with their declarations.
+
+     If these would be small, each regset is one chunk, so it is
+     just an ordinary regset.  Otherwise they are split into small chunks,
+     and chunks that would be all zero are not allocated.
+     Either way the space comes from the heap, not the stack.  */
+
+  if (n_basic_blocks * regset_bytes <= MAX_DENSE_LIFE_BYTES)
+    chunk_words = regset_size;
+  else
+    chunk_words = REGSET_CHUNK_WORDS;
+  regset_chunks = (regset_size + chunk_words - 1) / chunk_words;
+  chunks_allocated = 0;
+
+  obstack_init (&life_obstack);
+  basic_block_live_at_end = chunked_regset_vector (n_basic_blocks);
+  basic_block_new_live_at_end = chunked_regset_vector (n_basic_blocks);
+  basic_block_significant = chunked_regset_vector (n_basic_blocks);
+  scratch = (regset) alloca (regset_bytes);
 
   /* Propagate life info through the basic blocks
      around the graph of basic blocks.
@@ -539,127 +620,417 @@ life_analysis (f, nregs)
      to determine which registers are, as a consequence, live at the beginning
      of that block.  These registers must then be marked live at the ends
      of all the blocks that can transfer control to that block.
-     The process continues until it reaches a fixed point.  */
+     The process continues until it reaches a fixed point.
+
+     The blocks whose live-at-end sets may have grown are kept in a queue,
+     so that each step looks only at blocks that need it.  The queue starts
+     out holding every block in an order that tends to visit a block
+     after the blocks it can reach, so that most blocks are scanned
+     only once when there are no loops.  */
+
+  block_pred_start = (int *) alloca ((n_basic_blocks + 1) * sizeof (int));
+  block_preds = (int *) alloca (count_block_preds () * sizeof (int));
+  record_block_preds ();
+
+  block_queue = (int *) alloca (n_basic_blocks * sizeof (int));
+  life_order_blocks (block_queue);
+  queue_head = 0;
+  queue_length = n_basic_blocks;
+  block_queued = (char *) alloca (n_basic_blocks);
+  block_seen = (char *) alloca (n_basic_blocks);
+  bzero (block_seen, n_basic_blocks);
+  for (i = 0; i < n_basic_blocks; i++)
+    block_queued[i] = 1;
 
-  first_pass = 1;
-  changed = 1;
-  while (changed)
+  life_block_visits = 0;
+  life_block_rescans = 0;
+  life_block_requeues = 0;
+
+  while (queue_length > 0)
     {
-      changed = 0;
-      for (i = n_basic_blocks - 1; i >= 0; i--)
+      int first_pass;
+      int growth;
+      register int j;
+
+      i = block_queue[queue_head];
+      if (++queue_head == n_basic_blocks)
+	queue_head = 0;
+      queue_length--;
+      block_queued[i] = 0;
+      life_block_visits++;
+
+      /* The first time we see a block, it must be scanned
+	 to find its significant regs.  */
+      first_pass = ! block_seen[i];
+      block_seen[i] = 1;
+
+      /* See whether this block needs thinking about at all
+	 (that is, if the regs live now at the end of it
+	 are not the same as were live at the end of it when
+	 we last thought about it), and whether it needs to be
+	 thought about instruction by instruction (that is, if any additional
+	 reg that is live at the end now but was not live there before
+	 is one of the significant regs of this basic block).  */
+
+      if (first_pass)
+	growth = 2;
+      else
+	growth = chunked_regset_growth (basic_block_new_live_at_end[i],
+					basic_block_live_at_end[i],
+					basic_block_significant[i]);
+
+      if (growth == 0)
+	continue;
+
+      if (growth == 1)
 	{
-	  int consider = first_pass;
-	  int must_rescan = first_pass;
-	  register int j;
-
-	  /* Set CONSIDER if this block needs thinking about at all
-	     (that is, if the regs live now at the end of it
-	     are not the same as were live at the end of it when
-	     we last thought about it).
-	     Set must_rescan if it needs to be thought about
-	     instruction by instruction (that is, if any additional
-	     reg that is live at the end now but was not live there before
-	     is one of the significant regs of this basic block).  */
-
-	  for (j = 0; j < regset_size; j++)
-	    {
-	      register int x = basic_block_new_live_at_end[i][j]
-		      & ~basic_block_live_at_end[i][j];
-	      if (x)
-		consider = 1;
-	      if (x & basic_block_significant[i][j])
-		{
-		  must_rescan = 1;
-		  consider = 1;
-		  break;
-		}
-	    }
+	  /* No complete rescan needed;
+	     just record those variables newly known live at end
+	     as live at start as well.  */
+	  chunked_regset_catch_up (basic_block_live_at_end[i],
+				   basic_block_new_live_at_end[i],
+				   basic_block_live_at_start[i]);
+	}
+      else
+	{
+	  /* Update the basic_block_live_at_start
+	     by propagation backwards through the block.  */
+	  chunked_regset_copy (basic_block_live_at_end[i],
+			       basic_block_new_live_at_end[i]);
+	  chunked_regset_expand (basic_block_live_at_start[i],
+				 basic_block_live_at_end[i]);
+	  if (first_pass)
+	    bzero (scratch, regset_bytes);
+	  propagate_block (basic_block_live_at_start[i],
+			   basic_block_head[i], basic_block_end[i], 0,
+			   first_pass ? scratch : 0,
+			   i);
+	  if (first_pass)
+	    chunked_regset_ior (basic_block_significant[i], scratch);
+	  life_block_rescans++;
+	}
 
-	  if (! consider)
-	    continue;
+      /* Update the basic_block_new_live_at_end's of the blocks
+	 that can reach this one, and queue any whose set grew.  */
 
-	  /* The live_at_start of this block may be changing,
-	     so another pass will be required after this one.  */
-	  changed = 1;
+      for (j = block_pred_start[i]; j < block_pred_start[i + 1]; j++)
+	{
+	  register int from_block = block_preds[j];
 
-	  if (! must_rescan)
-	    {
-	      /* No complete rescan needed;
-		 just record those variables newly known live at end
-		 as live at start as well.  */
-	      for (j = 0; j < regset_size; j++)
-		{
-		  register int x = basic_block_new_live_at_end[i][j]
-			& ~basic_block_live_at_end[i][j];
-		  basic_block_live_at_start[i][j] |= x;
-		  basic_block_live_at_end[i][j] |= x;
-		}
-	    }
-	  else
+	  if (chunked_regset_ior (basic_block_new_live_at_end[from_block],
+				  basic_block_live_at_start[i])
+	      && ! block_queued[from_block])
 	    {
-	      /* Update the basic_block_live_at_start
-		 by propagation backwards through the block.  */
-	      bcopy (basic_block_new_live_at_end[i],
-		     basic_block_live_at_end[i], regset_bytes);
-	      bcopy (basic_block_live_at_end[i],
-		     basic_block_live_at_start[i], regset_bytes);
-	      propagate_block (basic_block_live_at_start[i],
-			       basic_block_head[i], basic_block_end[i], 0,
-			       first_pass ? basic_block_significant[i] : 0,
-			       i);
+	      register int tail = queue_head + queue_length;
+	      if (tail >= n_basic_blocks)
+		tail -= n_basic_blocks;
+	      block_queue[tail] = from_block;
+	      queue_length++;
+	      block_queued[from_block] = 1;
+	      life_block_requeues++;
 	    }
-
-	  {
-	    register rtx jump, head;
-	    /* Update the basic_block_new_live_at_end's of the block
-	       that falls through into this one (if any).  */
-	    head = basic_block_head[i];
-	    jump = PREV_INSN (head);
-	    if (basic_block_drops_in[i])
-	      {
-		register from_block = BLOCK_NUM (jump);
-		register int j;
-		for (j = 0; j < regset_size; j++)
-		  basic_block_new_live_at_end[from_block][j]
-		    |= basic_block_live_at_start[i][j];
-	      }
-	    /* Update the basic_block_new_live_at_end's of
-	       all the blocks that jump to this one.  */
-	    if (GET_CODE (head) == CODE_LABEL)
-	      for (jump = LABEL_REFS (head);
-		   jump != head;
-		   jump = LABEL_NEXTREF (jump))
-		{
-		  register from_block = BLOCK_NUM (CONTAINING_INSN (jump));
-		  register int j;
-		  for (j = 0; j < regset_size; j++)
-		    basic_block_new_live_at_end[from_block][j]
-		      |= basic_block_live_at_start[i][j];
-		}
-	  }
 	}
-      first_pass = 0;
     }
 
   /* Now the life information is accurate.
      Make one more pass over each basic block
      to delete dead stores, create autoincrement addressing
      and record how many times each register is used, is set, or dies.
-
-     To save time, we operate directly in basic_block_live_at_end[i],
-     thus destroying it (in fact, converting it into a copy of
-     basic_block_live_at_start[i]).  This is ok now because
-     basic_block_live_at_end[i] is no longer used past this point.  */
+     SCRATCH starts out as the regs live at the end of the block
+     and is converted into a copy of basic_block_live_at_start[i].  */
 
   for (i = 0; i < n_basic_blocks; i++)
     {
-      propagate_block (basic_block_live_at_end[i],
+      chunked_regset_expand (scratch, basic_block_live_at_end[i]);
+      propagate_block (scratch,
 		       basic_block_head[i], basic_block_end[i], 1, 0, i);
     }
+
+  life_chunk_bytes = chunks_allocated * chunk_words * sizeof (int)
+    + 3 * n_basic_blocks * regset_chunks * sizeof (regset);
+  obstack_free (&life_obstack, NULL);
 }
-
+
 /* Subroutines of life analysis.  */
 
+/* Set BLOCK_PRED_START[N] to the number of predecessors of blocks 0 through N-1
+   (that is, the index in BLOCK_PREDS of block N's first predecessor),
+   for N from 0 through N_BASIC_BLOCKS.  Return the total number.
+
+   The predecessors of a block are the block that falls into it, if any,
+   and the blocks of all the jumps to its label.  */
+
+static int
+count_block_preds ()
+{
+  register int i;
+  register int total = 0;
+
+  for (i = 0; i < n_basic_blocks; i++)
+    {
+      register rtx head = basic_block_head[i];
+
+      block_pred_start[i] = total;
+      if (basic_block_drops_in[i])
+	total++;
+      if (GET_CODE (head) == CODE_LABEL)
+	{
+	  register rtx ref;
+	  for (ref = LABEL_REFS (head); ref != head; ref = LABEL_NEXTREF (ref))
+	    total++;
+	}
+    }
+  block_pred_start[n_basic_blocks] = total;
+  return total;
+}
+
+/* Fill in BLOCK_PREDS, in the order counted by count_block_preds.  */
+
+static void
+record_block_preds ()
+{
+  register int i;
+  register int *p = block_preds;
+
+  for (i = 0; i < n_basic_blocks; i++)
+    {
+      register rtx head = basic_block_head[i];
+
+      if (basic_block_drops_in[i])
+	*p++ = BLOCK_NUM (PREV_INSN (head));
+      if (GET_CODE (head) == CODE_LABEL)
+	{
+	  register rtx ref;
+	  for (ref = LABEL_REFS (head); ref != head; ref = LABEL_NEXTREF (ref))
+	    *p++ = BLOCK_NUM (CONTAINING_INSN (ref));
+	}
+    }
+}
+
+/* Store in ORDER the numbers of all the basic blocks,
+   in reverse postorder of a depth-first walk of the predecessor graph
+   that starts from the last block.  Since life information flows
+   from each block to its predecessors, this puts each block ahead of
+   the blocks that can reach it, except around loops.  */
+
+static void
+life_order_blocks (order)
+     int *order;
+{
+  /* The walk's stack of blocks, and for each the index
+     of the next predecessor to look at.  */
+  int *stack = (int *) alloca (n_basic_blocks * sizeof (int));
+  int *next_pred = (int *) alloca (n_basic_blocks * sizeof (int));
+  char *visited = (char *) alloca (n_basic_blocks);
+  register int sp;
+  int start;
+  int n_done = 0;
+
+  bzero (visited, n_basic_blocks);
+
+  for (start = n_basic_blocks - 1; start >= 0; start--)
+    if (! visited[start])
+      {
+	visited[start] = 1;
+	stack[0] = start;
+	next_pred[0] = block_pred_start[start];
+	sp = 1;
+
+	while (sp > 0)
+	  {
+	    register int b = stack[sp - 1];
+
+	    if (next_pred[sp - 1] < block_pred_start[b + 1])
+	      {
+		register int pred = block_preds[next_pred[sp - 1]++];
+		if (! visited[pred])
+		  {
+		    visited[pred] = 1;
+		    stack[sp] = pred;
+		    next_pred[sp] = block_pred_start[pred];
+		    sp++;
+		  }
+	      }
+	    else
+	      {
+		/* All the blocks that reach B have been walked.  */
+		order[n_basic_blocks - 1 - n_done++] = b;
+		sp--;
+	      }
+	  }
+      }
+}
+
+/* Chunked regsets.
+
+   The regsets life_analysis keeps for each block are stored in chunks
+   of CHUNK_WORDS words.  A chunked regset is a vector of REGSET_CHUNKS
+   pointers, each to a chunk or zero if all the bits of that chunk are 0.
+   The chunks and vectors are allocated in life_obstack.  */
+
+/* Return a vector of N empty chunked regsets.  */
+
+static regset **
+chunked_regset_vector (n)
+     int n;
+{
+  register regset **vector
+    = (regset **) obstack_alloc (&life_obstack, n * sizeof (regset *));
+  register regset *space
+    = (regset *) obstack_alloc (&life_obstack,
+				n * regset_chunks * sizeof (regset));
+  register int i;
+
+  bzero (space, n * regset_chunks * sizeof (regset));
+  for (i = 0; i < n; i++)
+    vector[i] = space + i * regset_chunks;
+  return vector;
+}
+
+/* Return chunk C of the chunked regset SET, making it if necessary.  */
+
+static regset
+regset_chunk (set, c)
+     regset *set;
+     int c;
+{
+  if (set[c] == 0)
+    {
+      set[c] = (regset) obstack_alloc (&life_obstack,
+				       chunk_words * sizeof (int));
+      bzero (set[c], chunk_words * sizeof (int));
+      chunks_allocated++;
+    }
+  return set[c];
+}
+
+/* Return the number of words of a regset that lie in chunk C.
+   Only the last chunk can have fewer than CHUNK_WORDS.  */
+
+#define CHUNK_LENGTH(C) \
+  ((C) == regset_chunks - 1 ? regset_size - (C) * chunk_words : chunk_words)
+
+/* Compare the chunked regsets NEW and OLD, where OLD is a subset of NEW.
+   Return 0 if they are the same, 2 if NEW has a bit that OLD lacks
+   and that is also in SIGNIFICANT, or 1 if NEW has only other bits
+   that OLD lacks.  */
+
+static int
+chunked_regset_growth (new, old, significant)
+     regset *new, *old, *significant;
+{
+  register int c, j;
+  int growth = 0;
+
+  for (c = 0; c < regset_chunks; c++)
+    if (new[c] != 0)
+      {
+	register regset np = new[c], op = old[c], sp = significant[c];
+	register int len = CHUNK_LENGTH (c);
+
+	for (j = 0; j < len; j++)
+	  {
+	    register int x = op ? np[j] & ~op[j] : np[j];
+	    if (x)
+	      {
+		if (sp && (x & sp[j]))
+		  return 2;
+		growth = 1;
+	      }
+	  }
+      }
+  return growth;
+}
+
+/* Turn on in the chunked regset OLD and in the ordinary regset START
+   all the bits that are on in the chunked regset NEW but not in OLD.  */
+
+static void
+chunked_regset_catch_up (old, new, start)
+     regset *old, *new;
+     regset start;
+{
+  register int c, j;
+
+  for (c = 0; c < regset_chunks; c++)
+    if (new[c] != 0)
+      {
+	register regset np = new[c];
+	register regset sp = start + c * chunk_words;
+	register int len = CHUNK_LENGTH (c);
+
+	for (j = 0; j < len; j++)
+	  {
+	    register int x = np[j] & ~(old[c] ? old[c][j] : 0);
+	    if (x)
+	      {
+		regset_chunk (old, c)[j] |= x;
+		sp[j] |= x;
+	      }
+	  }
+      }
+}
+
+/* Copy the chunked regset FROM into the chunked regset TO.  */
+
+static void
+chunked_regset_copy (to, from)
+     regset *to, *from;
+{
+  register int c;
+
+  for (c = 0; c < regset_chunks; c++)
+    if (from[c] != 0)
+      bcopy (from[c], regset_chunk (to, c), chunk_words * sizeof (int));
+    else if (to[c] != 0)
+      bzero (to[c], chunk_words * sizeof (int));
+}
+
+/* Copy the chunked regset FROM into the ordinary regset TO.  */
+
+static void
+chunked_regset_expand (to, from)
+     regset to;
+     regset *from;
+{
+  register int c;
+
+  for (c = 0; c < regset_chunks; c++)
+    if (from[c] != 0)
+      bcopy (from[c], to + c * chunk_words, CHUNK_LENGTH (c) * sizeof (int));
+    else
+      bzero (to + c * chunk_words, CHUNK_LENGTH (c) * sizeof (int));
+}
+
+/* Inclusive-or the ordinary regset FROM into the chunked regset TO.
+   Return nonzero if this turned on any bits in TO.  */
+
+static int
+chunked_regset_ior (to, from)
+     regset *to;
+     regset from;
+{
+  register int c, j;
+  int changed = 0;
+
+  for (c = 0; c < regset_chunks; c++)
+    {
+      register regset fp = from + c * chunk_words;
+      register regset tp = to[c];
+      register int len = CHUNK_LENGTH (c);
+
+      for (j = 0; j < len; j++)
+	if (fp[j] & ~(tp ? tp[j] : 0))
+	  {
+	    if (tp == 0)
+	      tp = regset_chunk (to, c);
+	    tp[j] |= fp[j];
+	    changed = 1;
+	  }
+    }
+  return changed;
+}
+
 /* Allocate the permanent data structures that represent the results
    of life analysis.  Not static since used also for stupid life analysis.  */
 
@@ -672,14 +1043,14 @@ allocate_for_life_analysis ()
   regset_size = ((max_regno + REGSET_ELT_BITS - 1) / REGSET_ELT_BITS);
   regset_bytes = regset_size * sizeof (*(regset)0);
 
-  reg_n_refs = (short *) oballoc (max_regno * sizeof (short));
-  bzero (reg_n_refs, max_regno * sizeof (short));
+  reg_n_refs = (int *) oballoc (max_regno * sizeof (int));
+  bzero (reg_n_refs, max_regno * sizeof (int));
 
-  reg_n_sets = (short *) oballoc (max_regno * sizeof (short));
-  bzero (reg_n_sets, max_regno * sizeof (short));
+  reg_n_sets = (int *) oballoc (max_regno * sizeof (int));
+  bzero (reg_n_sets, max_regno * sizeof (int));
 
-  reg_n_deaths = (short *) oballoc (max_regno * sizeof (short));
-  bzero (reg_n_deaths, max_regno * sizeof (short));
+  reg_n_deaths = (int *) oballoc (max_regno * sizeof (int));
+  bzero (reg_n_deaths, max_regno * sizeof (int));
 
   reg_live_length = (int *) oballoc (max_regno * sizeof (int));
   bzero (reg_live_length, max_regno * sizeof (int));
@@ -687,7 +1058,7 @@ allocate_for_life_analysis ()
   reg_crosses_call = (char *) oballoc (max_regno);
   bzero (reg_crosses_call, max_regno);
 
-  reg_basic_block = (short *) oballoc (max_regno * sizeof (short));
+  reg_basic_block = (int *) oballoc (max_regno * sizeof (int));
   for (i = 0; i < max_regno; i++)
     reg_basic_block[i] = -1;
 
@@ -759,7 +1130,7 @@ propagate_block (old, first, last, final, significant, bnum)
      In each element, OFFSET is the byte-number within a regset
      for the register described by the element, and BIT is a mask
      for that register's bit within the byte.  */
-  register struct foo { short offset; short bit; } *regs_sometimes_live;
+  register struct foo { int offset; short bit; } *regs_sometimes_live;
   int sometimes_max = 0;
   /* This regset has 1 for each reg that we have seen live so far.
      It and REGS_SOMETIMES_LIVE are updated together.  */
@@ -772,10 +1143,10 @@ propagate_block (old, first, last, final, significant, bnum)
 
   if (final)
     {
-      register int i, offset, bit;
+      register int i;
 
       maxlive = (regset) alloca (regset_bytes);
-      bcopy (old, maxlive, regset_bytes);
+      COPY_REG_SET (maxlive, old);
       regs_sometimes_live
 	= (struct foo *) alloca (max_regno * sizeof (struct foo));
 
@@ -783,19 +1154,14 @@ propagate_block (old, first, last, final, significant, bnum)
 	 Enter them in MAXLIVE and REGS_SOMETIMES_LIVE.
 	 Also mark them as not local to any one basic block.  */
 
-      for (offset = 0, i = 0; offset < regset_size; offset++)
-	for (bit = 1; bit; bit <<= 1, i++)
-	  {
-	    if (i == max_regno)
-	      break;
-	    if (old[offset] & bit)
-	      {
-		reg_basic_block[i] = -2;
-		regs_sometimes_live[sometimes_max].offset = offset;
-		regs_sometimes_live[sometimes_max].bit = i % REGSET_ELT_BITS;
-		sometimes_max++;
-	      }
-	  }
+      EXECUTE_IF_SET_IN_REG_SET
+	(old, i,
+	 {
+	   reg_basic_block[i] = -2;
+	   regs_sometimes_live[sometimes_max].offset = i / REGSET_ELT_BITS;
+	   regs_sometimes_live[sometimes_max].bit = i % REGSET_ELT_BITS;
+	   sometimes_max++;
+	 });
     }
 
   /* Scan the block an insn at a time from end to beginning.  */
@@ -34,7 +34,9 @@ is made up of a program name, and arguments separated by spaces.
 The program name must be exact and start from root, since no path
 is searched and it is unreliable to depend on the current working directory.
 Redirection of input or output is not supported; the subprograms must
-accept filenames saying what files to read and write.
+accept filenames saying what files to read and write.  The one exception
+is %|, which sends the standard output of a command through a pipe
+into the standard input of the next one.
 
 In addition, the specs can contain %-sequences to substitute variable text
 or for conditional text.  Here is a table of all defined %-sequences.
@@ -65,6 +67,9 @@ or with constant text in a single argument.
 	be linked.
  %p	substitutes the standard macro predefinitions for the
 	current target machine.  Use this when running cpp.
+ %|	says that the standard output of the command containing the %|
+	is the standard input of the command on the next line.  The two
+	commands run at the same time, connected by a pipe.
  %{S}   substitutes the -S switch, if that switch was given to CC.
 	If that switch was not specified, this substitutes nothing.
  %{S*}  substitutes all the switches specified to CC whose names start
@@ -146,11 +151,11 @@ struct compiler compilers[] =
 	/* Note that we use the "cc1" from $PATH. */
   {".c",
    "cpp %{C} %p %{pedantic} %{D*} %{U*} %{I*} %i %{!E:%g.cpp}\n\
-%{!E:cc1 %g.cpp -quiet -dumpbase %i %{Y*} %{d*} %{m*} %{w} %{pedantic}\
+%{!E:cc1 %g.cpp -quiet -dumpbase %i %{Y*} %{d*} %{m*} %{f*} %{w} %{pedantic}\
 		     %{O:-opt}%{!O:-noreg}\
 		     %{g:-G}\
-		     -o %{S:%b}%{!S:%g}.s\n\
-     %{!S:as %{R} -o %{!c:%d}%w%b.o %g.s\n }}"},
+		     %{S:-o %b.s}%{!S:%{!pipe:-o %g.s}%{pipe:-o - %|}}\n\
+     %{!S:as %{R} -o %{!c:%d}%w%b.o %{!pipe:%g.s}\n }}"},
   {".s",
    "%{!S:as %{R} %i -o %{!c:%d}%w%b.o\n }"},
   /* Mark end of table */
@@ -188,6 +193,13 @@ struct temp_file
 
 struct temp_file *temp_file_queue;
 
+/* Define the list of output files of the command now running,
+   to delete if it fails.  When the command reads from a pipe,
+   it may have made its output from the partial output of a failed
+   command before it.  */
+
+struct temp_file *failure_delete_queue;
+
 /* Record FILENAME as a file to be deleted automatically.  */
 
 void
@@ -204,6 +216,33 @@ record_temp_file (filename)
   temp_file_queue = temp;
 }
 
+/* Record FILENAME as a file to be deleted if the command fails.  */
+
+void
+record_failure_file (filename)
+     char *filename;
+{
+  register struct temp_file *temp;
+  register char *name;
+  temp = (struct temp_file *) xmalloc (sizeof (struct temp_file));
+  name = (char *) xmalloc (strlen (filename) + 1);
+  strcpy (name, filename);
+  temp->next = failure_delete_queue;
+  temp->name = name;
+  failure_delete_queue = temp;
+}
+
+/* Delete the output files of a command that failed.  */
+
+void
+delete_failure_queue ()
+{
+  register struct temp_file *temp;
+  for (temp = failure_delete_queue; temp; temp = temp->next)
+    unlink (temp->name);
+  failure_delete_queue = 0;
+}
+
 /* Delete all the temporary files whose names we previously recorded.  */
 
 void
@@ -267,6 +306,29 @@ char *user_exec_prefix = 0;
 char *standard_exec_prefix = "/usr/local/lib/gcc-";
 char *standard_exec_prefix_1 = "/usr/lib/gcc-";
 
+/* Nonzero means %| has been seen: the standard output of the command
+   now being accumulated goes through a pipe to the next command.  */
+
+int pipe_output;
+
+/* If the previous command's output is going through a pipe,
+   this is the descriptor that the next command should read it from.
+   Otherwise it is -1.  */
+
+int pipe_input = -1;
+
+/* Number of processes started and not yet waited for.
+   All the commands of a pipeline are waited for together, after
+   the last one is started.  */
+
+int n_running;
+
+/* The process id and name of the command whose output is going
+   through the pipe, for error messages.  */
+
+int pipe_pid;
+char *pipe_program;
+
 /* Clear out the vector of arguments (after a command is executed).  */
 
 void
@@ -306,6 +368,8 @@ execute ()
   int size;
   char *temp;
   int win = 0;
+  int pipe_fd[2];
+  int value = 0;
 
   size = strlen (standard_exec_prefix);
   if (user_exec_prefix != 0 && strlen (user_exec_prefix) > size)
@@ -348,6 +412,8 @@ execute ()
 	  else
 	    fprintf (stderr, " %s", argbuf[i]);
 	}
+      if (pipe_output)
+	fprintf (stderr, " |");
       fprintf (stderr, "\n");
 #ifdef DEBUG
       fprintf (stderr, "\nGo ahead? (y or n) ");
@@ -360,11 +426,25 @@ execute ()
 #endif				/* DEBUG */
     }
 
+  if (pipe_output && pipe (pipe_fd) < 0)
+    pfatal_with_name ("pipe");
+
   pid = vfork ();
   if (pid < 0)
     pfatal_with_name ("vfork");
   if (pid == 0)
     {
+      if (pipe_input >= 0)
+	{
+	  dup2 (pipe_input, 0);
+	  close (pipe_input);
+	}
+      if (pipe_output)
+	{
+	  dup2 (pipe_fd[1], 1);
+	  close (pipe_fd[0]);
+	  close (pipe_fd[1]);
+	}
       if (win)
 	execv (temp, argbuf);
       else
@@ -372,13 +452,46 @@ execute ()
       perror_with_name (argbuf[0]);
       _exit (65);
     }
-  wait (&status);
-  if (WIFSIGNALED (status))
-    fatal ("Program %s got fatal signal %d.", argbuf[0], status.w_termsig);
-  if ((WIFEXITED (status) && status.w_retcode >= MIN_FATAL_STATUS)
-      || WIFSIGNALED (status))
-    return -1;
-  return 0;
+  n_running++;
+
+  if (pipe_input >= 0)
+    close (pipe_input);
+  pipe_input = -1;
+
+  /* If the output goes to the next command, start that one
+     before waiting for this one.  */
+  if (pipe_output)
+    {
+      close (pipe_fd[1]);
+      pipe_input = pipe_fd[0];
+      pipe_pid = pid;
+      pipe_program = argbuf[0];
+      return 0;
+    }
+
+  for (; n_running > 0; n_running--)
+    {
+      pid = wait (&status);
+      if (pid < 0)
+	break;
+      if (WIFSIGNALED (status))
+	{
+	  delete_failure_queue ();
+	  fatal ("Program %s got fatal signal %d.",
+		 pid == pipe_pid ? pipe_program : argbuf[0],
+		 status.w_termsig);
+	}
+      if (WIFEXITED (status) && status.w_retcode >= MIN_FATAL_STATUS)
+	value = -1;
+    }
+  n_running = 0;
+
+  /* If any command of a pipeline failed, the output of the last one
+     is not to be trusted even if that one succeeded.  */
+  if (value)
+    delete_failure_queue ();
+  failure_delete_queue = 0;
+  return value;
 }
 
 /* Find all the switches given to us
@@ -542,6 +655,7 @@ do_spec (spec)
   arg_going = 0;
   delete_this_arg = 0;
   this_is_output_file = 0;
+  pipe_output = 0;
 
   value = do_spec_1 (spec, 0);
   if (value == 0)
@@ -578,7 +692,10 @@ do_spec_1 (spec, nopercent)
 	    string = obstack_finish (&obstack);
 	    store_arg (string, delete_this_arg);
 	    if (this_is_output_file)
-	      outfiles[input_file_number] = string;
+	      {
+		outfiles[input_file_number] = string;
+		record_failure_file (string);
+	      }
 	  }
 	arg_going = 0;
 	if (argbuf_index)
@@ -592,6 +709,7 @@ do_spec_1 (spec, nopercent)
 	arg_going = 0;
 	delete_this_arg = 0;
 	this_is_output_file = 0;
+	pipe_output = 0;
 	break;
 
       case '\t':
@@ -603,7 +721,10 @@ do_spec_1 (spec, nopercent)
 	    string = obstack_finish (&obstack);
 	    store_arg (string, delete_this_arg);
 	    if (this_is_output_file)
-	      outfiles[input_file_number] = string;
+	      {
+		outfiles[input_file_number] = string;
+		record_failure_file (string);
+	      }
 	  }
 	/* Reinitialize for a new argument.  */
 	arg_going = 0;
@@ -646,6 +767,10 @@ do_spec_1 (spec, nopercent)
 	      this_is_output_file = 1;
 	      break;
 
+	    case '|':
+	      pipe_output = 1;
+	      break;
+
 	    case 'o':
 	      {
 		register int f;
@@ -778,6 +903,7 @@ fatal_error (signum)
 {
   signal (signum, SIG_DFL);
   delete_temp_files ();
+  delete_failure_queue ();
   /* Get the same signal again, this time not handled,
      so its normal effect occurs.  */
   kill (getpid (), signum);
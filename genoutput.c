@@ -61,6 +61,16 @@ and this notice must be preserved on all copies.  */
    in the machine description.  They are identified for the sake of
    other parts of the compiler by a zero element in `insn_template'.
 
+   9. An array of strings `insn_template_ops', indexed like `insn_template',
+   containing each constant template already parsed, so that final.c
+   need not scan it for `%' and operand numbers every time it is used.
+   Each string is a sequence of items, each of which is either
+   a byte N, from 1 to 0177, followed by N bytes of text to output as is,
+   or a byte 0200 + N, followed by one of the letters `l', `c', `a' or `n'
+   or by `%' if there is none, standing for `%' followed by that letter
+   and the operand number N.  The element is zero if `insn_template' is,
+   or if the template contains an operand number that will not fit.
+
 The code number of an insn is simply its position in the machine description;
 code numbers are assigned sequentially to entries in the description,
 starting with code number 0.
@@ -160,6 +170,90 @@ extern void output_asm_insn();\n\n");
   printf ("     rtx insn;\n{\n  switch (code_number)\n    {\n");
 }
 
+/* Print BYTE, as part of a C string constant.  */
+
+void
+output_string_byte (byte)
+     int byte;
+{
+  if (byte == '\\' || byte == '"')
+    printf ("\\%c", byte);
+  else if (byte >= ' ' && byte < 0177)
+    putchar (byte);
+  else
+    printf ("\\%03o", byte);
+}
+
+/* Print the element of `insn_template_ops' for template TEMPLATE,
+   which is parsed just as output_asm_insn in final.c would parse it.
+   The only backslashes in TEMPLATE are the escapes that read_rtx makes
+   for `\;', so the text is taken out of them here.  */
+
+void
+output_template_ops (template)
+     char *template;
+{
+  char *text, *ops;
+  register char *p, *q;
+  register int n = 0;
+  int i, c;
+
+  if (template == 0)
+    {
+      printf ("    0,\n");
+      return;
+    }
+
+  /* Copy the text of TEMPLATE into TEXT without the escapes.  */
+  text = (char *) xmalloc (strlen (template) + 1);
+  for (p = template, q = text; *p; p++)
+    if (*p != '\\')
+      *q++ = *p;
+    else if (*++p == 'n')
+      *q++ = '\n';
+    else if (*p == 't')
+      *q++ = '\t';
+    else
+      *q++ = *p;
+  *q = 0;
+
+  /* Each byte of TEXT becomes at most two bytes of OPS.  */
+  ops = (char *) xmalloc (2 * strlen (text) + 2);
+  p = text;
+  while (*p)
+    {
+      for (q = p; *q != 0 && *q != '%' && q - p < 0177; q++)
+	;
+      if (q != p)
+	{
+	  ops[n++] = q - p;
+	  while (p != q)
+	    ops[n++] = *p++;
+	  continue;
+	}
+
+      p++;
+      if (*p == 'l' || *p == 'c' || *p == 'a' || *p == 'n')
+	c = *p++;
+      else
+	c = '%';
+      i = atoi (p);
+      if (i < 0 || i >= 0177)
+	{
+	  printf ("    0,\n");
+	  return;
+	}
+      ops[n++] = 0200 + i;
+      ops[n++] = c;
+      while (*p >= '0' && *p <= '9') p++;
+    }
+
+  printf ("    \"");
+  for (i = 0; i < n; i++)
+    output_string_byte (ops[i] & 0377);
+  printf ("\",\n");
+}
+
 void
 output_epilogue ()
 {
@@ -178,6 +272,11 @@ output_epilogue ()
     }
   printf ("  };\n");
 
+  printf ("\nchar *insn_template_ops[] =\n  {\n");
+  for (d = insn_data; d; d = d->next)
+    output_template_ops (d->template);
+  printf ("  };\n");
+
   printf ("\nrtx (*insn_gen_function[]) () =\n  {\n");
   for (d = insn_data; d; d = d->next)
     {
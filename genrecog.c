@@ -66,6 +66,7 @@ struct decision
   int test_elt_one_int;
   int elt_one_int;
   int ignmode;
+  int igncode;
   struct decision *afterward;
   int label_needed;
   char *c_test;
@@ -124,6 +125,16 @@ void fatal ();
 
 struct decision *first;
 
+/* A switch is made on the codes or modes of alternatives
+   only if there are at least this many different ones.  */
+
+#define SWITCH_MIN 3
+
+/* Statistics about the code written, for the comment at the end.  */
+
+int n_switches;
+int n_factored;
+
 /* Construct and return a sequence of decisions
    that will recognize INSN.  */
 
@@ -188,6 +199,7 @@ add_to_sequence (pattern, last, position)
   new->elt_one_int = 0;
   new->enforce_mode = 0;
   new->ignmode = 0;
+  new->igncode = 0;
   new->afterward = 0;
   new->label_needed = 0;
   new->c_test = 0;
@@ -503,6 +515,7 @@ write_tree (tree, prevpos, afterward, afterpos)
   register int depth;
   int ignmode;
   enum { NO_SWITCH, CODE_SWITCH, MODE_SWITCH } in_switch = NO_SWITCH;
+  struct decision *switch_end = 0;
   char modemap[NUM_MACHINE_MODE];
   char codemap[NUM_RTX_CODE];
 
@@ -528,12 +541,7 @@ write_tree (tree, prevpos, afterward, afterpos)
       p->afterward = p1;
       if (p1) p1->label_needed = 1;
 
-      if (in_switch == MODE_SWITCH && (p->mode == VOIDmode || p->tests != 0))
-	{
-	  in_switch = NO_SWITCH;
-	  printf ("  }\n");
-	}
-      if (in_switch == CODE_SWITCH && p->code == UNKNOWN)
+      if (in_switch != NO_SWITCH && p == switch_end)
 	{
 	  in_switch = NO_SWITCH;
 	  printf ("  }\n");
@@ -590,43 +598,90 @@ write_tree (tree, prevpos, afterward, afterpos)
 	    }
 	}
 
-      /* If p and its alternatives all have different modes
-	 and there are at least 4 of them, make a switch.  */
+      /* If p and the alternatives after it that test the same place
+	 all have different modes, and there are at least SWITCH_MIN
+	 of them, make a switch.  */
       if (in_switch == NO_SWITCH && pos[depth-1] != '*')
 	{
 	  register int i;
 	  bzero (modemap, sizeof modemap);
-	  for (p1 = p, i = 0; p1 && p1->mode != VOIDmode && p1->tests == 0;
+	  for (p1 = p, i = 0; p1 && p1->mode != VOIDmode && p1->tests == 0
+	       && !strcmp (p1->position, pos);
 	       p1 = p1->next, i++)
 	    {
 	      if (! p->enforce_mode && modemap[(int) p1->mode])
 		break;
 	      modemap[(int) p1->mode] = 1;
 	    }
-	  if ((p1 == 0 || p1->mode == VOIDmode || p1->tests != 0) && i >= 4)
+	  if ((p1 == 0 || p1->mode == VOIDmode || p1->tests != 0
+	       || strcmp (p1->position, pos))
+	      && i >= SWITCH_MIN && ! labels_within (p, p1))
 	    {
 	      in_switch = MODE_SWITCH;
+	      switch_end = p1;
+	      n_switches++;
 	      printf (" switch (GET_MODE (x%d))\n  {\n", depth);
 	    }
 	}
 
+      /* Likewise for codes.  Here the same code may appear more
+	 than once; a failing alternative jumps to the next one
+	 with its code, as below.  */
       if (in_switch == NO_SWITCH)
 	{
 	  register int i;
 	  bzero (codemap, sizeof codemap);
-	  for (p1 = p, i = 0; p1 && p1->code != UNKNOWN; p1 = p1->next, i++)
+	  for (p1 = p, i = 0; p1 && p1->code != UNKNOWN
+	       && !strcmp (p1->position, pos);
+	       p1 = p1->next)
 	    {
-	      if (codemap[(int) p1->code])
-		break;
+	      if (! codemap[(int) p1->code])
+		i++;
 	      codemap[(int) p1->code] = 1;
 	    }
-	  if ((p1 == 0 || p1->code == UNKNOWN) && i >= 4)
+	  if (i >= SWITCH_MIN && ! labels_within (p, p1))
 	    {
 	      in_switch = CODE_SWITCH;
+	      switch_end = p1;
+	      n_switches++;
 	      printf (" switch (GET_CODE (x%d))\n  {\n", depth);
 	    }
 	}
 
+      /* Outside a switch, if p and the alternatives right after it
+	 test for the same code, or the same mode, test that once
+	 for all of them.  */
+      if (in_switch == NO_SWITCH && p->code != UNKNOWN && !p->exact
+	  && !p->igncode)
+	{
+	  for (p1 = p->next; p1 && p1->code == p->code && !p1->exact
+	       && !strcmp (p1->position, pos) && !p1->label_needed;
+	       p1 = p1->next);
+	  if (p1 != p->next)
+	    {
+	      printf ("  if (GET_CODE (x%d) != ", depth);
+	      print_code (p->code);
+	      printf (")\n");
+	      write_skip (p1, pos, afterward, afterpos);
+	      factor_run (p, p1, 1);
+	    }
+	}
+      if (in_switch == NO_SWITCH && p->mode != VOIDmode && !ignmode)
+	{
+	  for (p1 = p->next; p1 && p1->mode == p->mode && p1->tests == 0
+	       && !p1->ignmode && !strcmp (p1->position, pos)
+	       && !p1->label_needed;
+	       p1 = p1->next);
+	  if (p1 != p->next)
+	    {
+	      printf ("  if (GET_MODE (x%d) != %smode)\n",
+		      depth, GET_MODE_NAME (p->mode));
+	      write_skip (p1, pos, afterward, afterpos);
+	      factor_run (p, p1, 0);
+	      ignmode = 1;
+	    }
+	}
+
       if (in_switch == MODE_SWITCH)
 	{
 	  if (modemap[(int) p->mode])
@@ -647,7 +702,8 @@ write_tree (tree, prevpos, afterward, afterpos)
 	}
 
       printf ("  if (");
-      if (p->code != UNKNOWN && (p->exact || in_switch != CODE_SWITCH))
+      if (p->code != UNKNOWN
+	  && (p->exact || (in_switch != CODE_SWITCH && !p->igncode)))
 	{
 	  register char *p1;
 	  if (p->exact)
@@ -700,12 +756,14 @@ write_tree (tree, prevpos, afterward, afterpos)
 
       if (in_switch == CODE_SWITCH)
 	{
-	  /* Find the next alternative to p
-	     that might be applicable if p was applicable.  */
-	  for (p1 = p->next; p1; p1 = p1->next)
+	  /* Find the next alternative to p within the switch
+	     that might be applicable if p was applicable.
+	     The alternatives from switch_end on test another position
+	     or are not in the switch; breaking out reaches them.  */
+	  for (p1 = p->next; p1 && p1 != switch_end; p1 = p1->next)
 	    if (p1->code == UNKNOWN || p->code == p1->code)
 	      break;
-	  if (p1 == 0 || p1->code == UNKNOWN)
+	  if (p1 == 0 || p1 == switch_end || p1->code == UNKNOWN)
 	    printf ("  break;\n");
 	  else if (p1 != p->next)
 	    {
@@ -716,12 +774,14 @@ write_tree (tree, prevpos, afterward, afterpos)
 
       if (in_switch == MODE_SWITCH)
 	{
-	  /* Find the next alternative to p
-	     that might be applicable if p was applicable.  */
-	  for (p1 = p->next; p1; p1 = p1->next)
+	  /* Find the next alternative to p within the switch
+	     that might be applicable if p was applicable.
+	     The alternatives from switch_end on test another position
+	     or are not in the switch; breaking out reaches them.  */
+	  for (p1 = p->next; p1 && p1 != switch_end; p1 = p1->next)
 	    if (p1->mode == VOIDmode || p->mode == p1->mode)
 	      break;
-	  if (p1 == 0 || p1->mode == VOIDmode)
+	  if (p1 == 0 || p1 == switch_end || p1->mode == VOIDmode)
 	    printf ("  break;\n");
 	  else if (p1 != p->next)
 	    {
@@ -752,6 +812,92 @@ write_tree (tree, prevpos, afterward, afterpos)
       }
 }
 
+/* Return 1 if any alternative after P, up to but not including END,
+   is the target of a jump already written.  */
+
+labels_within (p, end)
+     struct decision *p, *end;
+{
+  for (p = p->next; p != end; p = p->next)
+    if (p->label_needed)
+      return 1;
+  return 0;
+}
+
+/* Write the jump taken when a test shared by a run of alternatives
+   fails: to the alternative P after the run, or if there is none,
+   to AFTERWARD at position AFTERPOS, as at the end of `write_tree'.
+   POS is the current position.  */
+
+write_skip (p, pos, afterward, afterpos)
+     struct decision *p;
+     char *pos;
+     int afterward;
+     char *afterpos;
+{
+  if (p)
+    {
+      printf ("    goto L%d;\n", p->number);
+      p->label_needed = 1;
+    }
+  else if (afterward)
+    {
+      printf ("    {");
+      change_state (pos, afterpos);
+      printf ("    goto L%d; }\n", afterward);
+    }
+  else
+    printf ("    goto ret0;\n");
+}
+
+/* Mark the alternatives from P up to but not including END as not
+   needing their own test of the code (if CODE) or mode,
+   since it has been tested for all of them.  */
+
+factor_run (p, end, code)
+     struct decision *p, *end;
+     int code;
+{
+  for (; p != end; p = p->next)
+    {
+      if (code)
+	p->igncode = 1;
+      else
+	p->ignmode = 1;
+      n_factored++;
+    }
+}
+
+/* Return the number of nodes in the decision tree TREE.  */
+
+count_nodes (tree)
+     struct decision *tree;
+{
+  register struct decision *p;
+  register int n = 0;
+
+  for (p = tree; p; p = p->next)
+    n += 1 + count_nodes (p->success);
+  return n;
+}
+
+/* Return the number of decisions on the longest path through TREE.  */
+
+tree_depth (tree)
+     struct decision *tree;
+{
+  register struct decision *p;
+  register int depth = 0, d;
+
+  for (p = tree; p; p = p->next)
+    {
+      d = 1 + tree_depth (p->success);
+      if (d > depth)
+	depth = d;
+    }
+  return depth;
+}
+
 print_code (code)
      RTX_CODE code;
 {
@@ -966,5 +1112,8 @@ from the machine description file `md'.  */\n\n");
   startpos = "";
   write_tree (tree, startpos, 0, "");
   printf (" ret0: return -1;\n}\n");
+  printf ("\n/* Decision tree: %d nodes, %d deep.\n\
+   %d switches; %d tests of codes or modes shared.  */\n",
+	  count_nodes (tree), tree_depth (tree), n_switches, n_factored);
   return 0;
 }
@@ -46,7 +46,8 @@ and this notice must be preserved on all copies.  */
    reg numbers to allocnos and vice versa.
    max_allocno gets the number of allocnos in use.
 
-   2. Allocate a max_allocno by max_allocno conflict bit matrix and clear it.
+   2. Allocate a max_allocno by max_allocno conflict bit matrix and clear it,
+   or, if that would be too big, a hash table of conflicting pairs.
    Allocate a max_allocno by FIRST_PSEUDO_REGISTER conflict matrix
    for conflicts between allocnos and explicit hard register use
    (which includes use of pseudo-registers allocated by local_alloc).
@@ -59,11 +60,17 @@ and this notice must be preserved on all copies.  */
     Someday also record the preferred hardware registers
     for each unallocated one.
 
+   In the hashed case, then turn the pairs into a vector of
+   the allocnos that conflict with each allocno.
+
    4. Sort a table of the allocnos into order of
    desirability of the variables.
 
    5. Allocate the variables in that order; each if possible into
-   an preferred register, else into another register.  */
+   an preferred register, else into another register.
+
+   With -fcolor-regs, step 5 is replaced by coloring the conflict graph
+   (see `color_allocnos'), which also coalesces copies between pseudos.  */
 
 /* Number of pseudo-registers still requiring allocation
    (not allocated by local_allocate).  */
@@ -94,10 +101,48 @@ static int *allocno_size;
    hardware register).
 
    `conflicts' is not symmetric; a conflict between allocno's i and j
-   is recorded either in element i,j or in element j,i.  */
+   is recorded either in element i,j or in element j,i.
+
+   This is zero if there are too many allocnos for such a matrix;
+   then the conflicts are kept in `conflict_hash' instead.  */
 
 static int *conflicts;
 
+/* If the bit matrix would take more than this many bytes,
+   the conflicts are recorded sparsely instead.  */
+
+#ifndef MAX_DENSE_CONFLICT_BYTES
+#define MAX_DENSE_CONFLICT_BYTES 262144
+#endif
+
+/* Open hash table of the pairs of allocnos that conflict,
+   used when `conflicts' is zero.  Each slot is two ints:
+   the smaller allocno of the pair and the larger.
+   An empty slot has -1 in its first int.  */
+
+static int *conflict_hash;
+
+/* Number of slots in `conflict_hash' (a power of 2),
+   and number of them in use.  */
+
+static int conflict_hash_size;
+static int conflict_hash_count;
+
+/* When the conflicts are recorded sparsely, once they are all known
+   the allocnos that conflict with allocno N are
+   conflict_vec[conflict_index[N]] through conflict_vec[conflict_index[N+1]-1],
+   in increasing order.  */
+
+static int *conflict_index;
+static int *conflict_vec;
+
+/* Number of distinct pairs of allocnos that conflict,
+   and the most bytes the conflict graph occupied at any time.
+   These are for the dump file.  */
+
+static int conflict_edges;
+static int conflict_bytes;
+
 /* Number of ints require to hold max_allocno bits.
    This is the length of a row in `conflicts'.  */
 
@@ -164,6 +209,23 @@ static void dump_conflicts ();
 static void find_reg ();
 static void global_conflicts ();
 static void record_conflicts ();
+static void record_sparse_conflicts ();
+static void add_conflict_pair ();
+static void build_conflict_vec ();
+static void conflict_vec_from_matrix ();
+static void assign_allocno_reg ();
+static int allocno_avail_regs ();
+static double group_spill_cost ();
+static void color_allocnos ();
+
+#define MIN(x,y) ((x) < (y) ? (x) : (y))
+
+/* Nonzero means allocate by coloring the conflict graph.  -fcolor-regs.  */
+
+extern int color_regs;
+
+extern int xmalloc ();
+extern void free ();
 
 
 /* Tables describing and classifying the hardware registers.  */
@@ -260,9 +322,33 @@ global_alloc (file)
 
   allocno_row_words = (max_allocno + INT_BITS - 1) / INT_BITS;
 
-  conflicts = (int *)
-    alloca (max_allocno * allocno_row_words * sizeof (int));
-  bzero (conflicts, max_allocno * allocno_row_words * sizeof (int));
+  /* A bit matrix is fastest, but its size goes as the square of
+     the number of allocnos; for a big function, hash the pairs.  */
+
+  conflict_edges = 0;
+  conflict_hash = 0;
+  conflict_index = 0;
+  conflict_vec = 0;
+  conflict_bytes = max_allocno * allocno_row_words * sizeof (int);
+
+  if (conflict_bytes <= MAX_DENSE_CONFLICT_BYTES)
+    {
+      conflicts = (int *) alloca (conflict_bytes);
+      bzero (conflicts, conflict_bytes);
+    }
+  else
+    {
+      conflicts = 0;
+      conflict_bytes = 0;
+      conflict_hash_count = 0;
+      for (conflict_hash_size = 1024;
+	   conflict_hash_size < 4 * max_allocno;
+	   conflict_hash_size *= 2);
+      conflict_hash
+	= (int *) xmalloc (2 * conflict_hash_size * sizeof (int));
+      for (i = 0; i < conflict_hash_size; i++)
+	conflict_hash[2 * i] = -1;
+    }
 
   allocnos_live = (int *) alloca (allocno_row_words * sizeof (int));
 
@@ -276,6 +362,9 @@ global_alloc (file)
 
       global_conflicts ();
 
+      if (conflicts == 0)
+	build_conflict_vec ();
+
       /* Determine the order to allocate the remaining pseudo registers.  */
 
       allocno_order = (int *) alloca (max_allocno * sizeof (int));
@@ -295,19 +384,22 @@ global_alloc (file)
 
       /* Try allocating them, one by one, in that order.  */
 
-      for (i = 0; i < max_allocno; i++)
-	{
-	  /* If we have more than one register class,
-	     first try allocating in the class that is cheapest
-	     for this pseudo-reg.  If that fails, try any reg.  */
-	  if (N_REG_CLASSES > 1)
-	    {
-	      find_reg (allocno_order[i], 0, 0);
-	      if (reg_renumber[allocno_reg[allocno_order[i]]] >= 0)
-		continue;
-	    }
-	  find_reg (allocno_order[i], 0, 1);
-	}
+      if (color_regs)
+	color_allocnos (file);
+      else
+	for (i = 0; i < max_allocno; i++)
+	  {
+	    /* If we have more than one register class,
+	       first try allocating in the class that is cheapest
+	       for this pseudo-reg.  If that fails, try any reg.  */
+	    if (N_REG_CLASSES > 1)
+	      {
+		find_reg (allocno_order[i], 0, 0);
+		if (reg_renumber[allocno_reg[allocno_order[i]]] >= 0)
+		  continue;
+	      }
+	    find_reg (allocno_order[i], 0, 1);
+	  }
     }
 
   /* Do the reloads now while the allocno data still exist, so that we can
@@ -315,6 +407,12 @@ global_alloc (file)
 
   if (n_basic_blocks > 0)
     reload (basic_block_head[0], 1, file);
+
+  if (conflict_index)
+    {
+      free (conflict_index);
+      free (conflict_vec);
+    }
 }
 
 /* Sort predicate for ordering the allocnos.
@@ -345,9 +443,9 @@ global_conflicts ()
 {
   register int b, i;
   register rtx insn;
-  short *block_start_allocnos;
+  int *block_start_allocnos;
 
-  block_start_allocnos = (short *) alloca (max_allocno * sizeof (short));
+  block_start_allocnos = (int *) alloca (max_allocno * sizeof (int));
 
   for (b = 0; b < n_basic_blocks; b++)
     {
@@ -367,7 +465,6 @@ global_conflicts ()
 	 are explicitly marked in basic_block_live_at_start.  */
 
       {
-	register int offset, bit;
 	register regset old = basic_block_live_at_start[b];
 	int ax = 0;
 
@@ -376,26 +473,18 @@ global_conflicts ()
 #else
 	COPY_HARD_REG_SET (hard_regs_live, old);
 #endif
-	for (offset = 0, i = 0; offset < regset_size; offset++)
-	  if (old[offset] == 0)
-	    i += HOST_BITS_PER_INT;
-	  else
-	    for (bit = 1; bit; bit <<= 1, i++)
-	      {
-		if (i >= max_regno)
-		  break;
-		if (old[offset] & bit)
-		  {
-		    register int a = reg_allocno[i];
-		    if (a >= 0)
-		      {
-			SET_ALLOCNO_LIVE (a);
-			block_start_allocnos[ax++] = a;
-		      }
-		    else if ((a = reg_renumber[i]) >= 0)
-		      mark_reg_live_nc (a, PSEUDO_REGNO_MODE (i));
-		  }
-	      }
+	EXECUTE_IF_SET_IN_REG_SET
+	  (old, i,
+	   {
+	     register int a = reg_allocno[i];
+	     if (a >= 0)
+	       {
+		 SET_ALLOCNO_LIVE (a);
+		 block_start_allocnos[ax++] = a;
+	       }
+	     else if ((a = reg_renumber[i]) >= 0)
+	       mark_reg_live_nc (a, PSEUDO_REGNO_MODE (i));
+	   });
 
 	/* Record that each allocno now live conflicts with each other
 	   allocno now live, and with each hard reg now live.  */
@@ -532,25 +621,39 @@ find_reg (allocno, losers, all_regs_p)
 
   /* Did we find a register?  */
   if (i < FIRST_PSEUDO_REGISTER)
-    {
-      register int lim, j;
-      HARD_REG_SET this_reg;
-
-      /* Yes.  Record it as the hard register of this pseudo-reg.  */
-      reg_renumber[allocno_reg[allocno]] = i;
-      /* For each other pseudo-reg conflicting with this one,
-	 mark it as conflicting with the hard regs this one occupies.  */
-      CLEAR_HARD_REG_SET (this_reg);
-      lim = i + HARD_REGNO_NREGS (i, mode);
-      for (j = i; j < lim; j++)
-	SET_HARD_REG_BIT (this_reg, j);
-      lim = allocno;
-      for (j = 0; j < max_allocno; j++)
-	if (CONFLICTP (lim, j) || CONFLICTP (j, lim))
-	  {
-	    IOR_HARD_REG_SET (hard_reg_conflicts[j], this_reg);
-	  }
-    }
+    assign_allocno_reg (allocno, i);
+}
+
+/* Record hard reg REGNO as the allocation of ALLOCNO.  */
+
+static void
+assign_allocno_reg (allocno, regno)
+     int allocno, regno;
+{
+  enum machine_mode mode = PSEUDO_REGNO_MODE (allocno_reg[allocno]);
+  register int lim, j;
+  HARD_REG_SET this_reg;
+
+  /* Record it as the hard register of this pseudo-reg.  */
+  reg_renumber[allocno_reg[allocno]] = regno;
+  /* For each other pseudo-reg conflicting with this one,
+     mark it as conflicting with the hard regs this one occupies.  */
+  CLEAR_HARD_REG_SET (this_reg);
+  lim = regno + HARD_REGNO_NREGS (regno, mode);
+  for (j = regno; j < lim; j++)
+    SET_HARD_REG_BIT (this_reg, j);
+  lim = allocno;
+  if (conflicts == 0)
+    for (j = conflict_index[lim]; j < conflict_index[lim + 1]; j++)
+      {
+	IOR_HARD_REG_SET (hard_reg_conflicts[conflict_vec[j]], this_reg);
+      }
+  else
+    for (j = 0; j < max_allocno; j++)
+      if (CONFLICTP (lim, j) || CONFLICTP (j, lim))
+	{
+	  IOR_HARD_REG_SET (hard_reg_conflicts[j], this_reg);
+	}
 }
 
 /* Called from `reload' when pseudo reg I is being spilled from its
@@ -607,8 +710,11 @@ record_one_conflict (regno)
       register int ialloc = reg_allocno[regno];
       register int ialloc_prod = ialloc * allocno_row_words;
       IOR_HARD_REG_SET (hard_reg_conflicts[ialloc], hard_regs_live);
-      for (j = allocno_row_words - 1; j >= 0; j--)
-	conflicts[ialloc_prod + j] |= allocnos_live[j];
+      if (conflicts == 0)
+	record_sparse_conflicts (ialloc);
+      else
+	for (j = allocno_row_words - 1; j >= 0; j--)
+	  conflicts[ialloc_prod + j] |= allocnos_live[j];
     }
 }
 
@@ -619,7 +725,7 @@ record_one_conflict (regno)
 
 static void
 record_conflicts (allocno_vec, len)
-     register short *allocno_vec;
+     register int *allocno_vec;
      register int len;
 {
   register int allocno;
@@ -631,11 +737,520 @@ record_conflicts (allocno_vec, len)
       allocno = allocno_vec[len];
       ialloc_prod = allocno * allocno_row_words;
       IOR_HARD_REG_SET (hard_reg_conflicts[allocno], hard_regs_live);
-      for (j = allocno_row_words - 1; j >= 0; j--)
-	conflicts[ialloc_prod + j] |= allocnos_live[j];
+      if (conflicts == 0)
+	record_sparse_conflicts (allocno);
+      else
+	for (j = allocno_row_words - 1; j >= 0; j--)
+	  conflicts[ialloc_prod + j] |= allocnos_live[j];
     }
 }
+
+/* Record ALLOCNO as conflicting with each allocno currently live,
+   in the hash table of conflicting pairs.  As with the bit matrix,
+   this includes ALLOCNO itself if it is live.  */
+
+static void
+record_sparse_conflicts (allocno)
+     int allocno;
+{
+  register int i, j;
+
+  for (i = 0; i < allocno_row_words; i++)
+    if (allocnos_live[i] != 0)
+      for (j = 0; j < INT_BITS; j++)
+	if (allocnos_live[i] & (1 << j))
+	  add_conflict_pair (allocno, i * INT_BITS + j);
+}
+
+/* Enter the pair of allocnos A1 and A2 in `conflict_hash'
+   unless it is there already.  Enlarge the table when it gets
+   three quarters full.  */
+
+static void
+add_conflict_pair (a1, a2)
+     int a1, a2;
+{
+  register int lo = a1 < a2 ? a1 : a2;
+  register int hi = a1 < a2 ? a2 : a1;
+  register int mask = conflict_hash_size - 1;
+  register int h = ((unsigned) (lo * 31 + hi) * 0x9e3779b1) >> 8 & mask;
+
+  while (conflict_hash[2 * h] >= 0)
+    {
+      if (conflict_hash[2 * h] == lo && conflict_hash[2 * h + 1] == hi)
+	return;
+      h = (h + 1) & mask;
+    }
+
+  conflict_hash[2 * h] = lo;
+  conflict_hash[2 * h + 1] = hi;
+  if (lo != hi)
+    conflict_edges++;
+
+  if (++conflict_hash_count * 4 >= conflict_hash_size * 3)
+    {
+      register int *old = conflict_hash;
+      register int old_size = conflict_hash_size;
+      register int i;
+      int bytes;
+
+      conflict_hash_size *= 2;
+      conflict_hash
+	= (int *) xmalloc (2 * conflict_hash_size * sizeof (int));
+      for (i = 0; i < conflict_hash_size; i++)
+	conflict_hash[2 * i] = -1;
+
+      bytes = 2 * (old_size + conflict_hash_size) * sizeof (int);
+      if (bytes > conflict_bytes)
+	conflict_bytes = bytes;
+
+      mask = conflict_hash_size - 1;
+      for (i = 0; i < old_size; i++)
+	if ((lo = old[2 * i]) >= 0)
+	  {
+	    hi = old[2 * i + 1];
+	    h = ((unsigned) (lo * 31 + hi) * 0x9e3779b1) >> 8 & mask;
+	    while (conflict_hash[2 * h] >= 0)
+	      h = (h + 1) & mask;
+	    conflict_hash[2 * h] = lo;
+	    conflict_hash[2 * h + 1] = hi;
+	  }
+      free (old);
+    }
+}
+
+/* Comparison function for sorting a vector of allocnos.  */
+
+static int
+allocno_compare (v1, v2)
+     int *v1, *v2;
+{
+  return *v1 - *v2;
+}
+
+/* Turn the pairs in `conflict_hash' into `conflict_index' and
+   `conflict_vec', listing the allocnos that conflict with each allocno
+   in the order in which the bit matrix would yield them.
+   Then free the hash table.  */
+
+static void
+build_conflict_vec ()
+{
+  register int i, lo, hi;
+  int *fill;
+  int bytes;
+
+  conflict_index = (int *) xmalloc ((max_allocno + 1) * sizeof (int));
+  bzero (conflict_index, (max_allocno + 1) * sizeof (int));
+
+  for (i = 0; i < conflict_hash_size; i++)
+    if ((lo = conflict_hash[2 * i]) >= 0)
+      {
+	hi = conflict_hash[2 * i + 1];
+	conflict_index[lo + 1]++;
+	if (hi != lo)
+	  conflict_index[hi + 1]++;
+      }
+
+  for (i = 0; i < max_allocno; i++)
+    conflict_index[i + 1] += conflict_index[i];
+
+  conflict_vec
+    = (int *) xmalloc ((conflict_index[max_allocno] + 1) * sizeof (int));
+  fill = (int *) xmalloc (max_allocno * sizeof (int));
+  bcopy (conflict_index, fill, max_allocno * sizeof (int));
+
+  for (i = 0; i < conflict_hash_size; i++)
+    if ((lo = conflict_hash[2 * i]) >= 0)
+      {
+	hi = conflict_hash[2 * i + 1];
+	conflict_vec[fill[lo]++] = hi;
+	if (hi != lo)
+	  conflict_vec[fill[hi]++] = lo;
+      }
+
+  for (i = 0; i < max_allocno; i++)
+    if (conflict_index[i + 1] - conflict_index[i] > 1)
+      qsort (conflict_vec + conflict_index[i],
+	     conflict_index[i + 1] - conflict_index[i],
+	     sizeof (int), allocno_compare);
+
+  bytes = (2 * conflict_hash_size + 2 * max_allocno + 1
+	   + conflict_index[max_allocno]) * sizeof (int);
+  if (bytes > conflict_bytes)
+    conflict_bytes = bytes;
+
+  free (fill);
+  free (conflict_hash);
+  conflict_hash = 0;
+}
 
+/* Make `conflict_index' and `conflict_vec' from the bit matrix,
+   for the coloring allocator, which wants each allocno's neighbors.  */
+
+static void
+conflict_vec_from_matrix ()
+{
+  register int i, j, k;
+
+  conflict_index = (int *) xmalloc ((max_allocno + 1) * sizeof (int));
+  k = 0;
+  for (i = 0; i < max_allocno; i++)
+    for (j = 0; j < max_allocno; j++)
+      if (CONFLICTP (i, j) || CONFLICTP (j, i))
+	k++;
+
+  conflict_vec = (int *) xmalloc ((k + 1) * sizeof (int));
+  k = 0;
+  for (i = 0; i < max_allocno; i++)
+    {
+      conflict_index[i] = k;
+      for (j = 0; j < max_allocno; j++)
+	if (CONFLICTP (i, j) || CONFLICTP (j, i))
+	  conflict_vec[k++] = j;
+    }
+  conflict_index[max_allocno] = k;
+}
+
+/* Return the number of hard regs that ALLOCNO could go in,
+   judging by its preferred class and the hard regs it conflicts with.  */
+
+static int
+allocno_avail_regs (allocno)
+     int allocno;
+{
+  register int i, n = 0;
+  HARD_REG_SET used;
+  int regno = allocno_reg[allocno];
+
+  COPY_HARD_REG_SET (used,
+		     (reg_crosses_call[regno]
+		      ? call_clobbered_reg_set : fixed_reg_set));
+  IOR_COMPL_HARD_REG_SET (used,
+			  reg_class_contents[(int) reg_preferred_class (regno)]);
+  IOR_HARD_REG_SET (used, hard_reg_conflicts[allocno]);
+
+  for (i = 0; i < FIRST_PSEUDO_REGISTER; i++)
+    if (! TEST_HARD_REG_BIT (used, i))
+      n++;
+  return n;
+}
+
+/* Return the cost of leaving the group of allocnos led by GROUP
+   out of hard regs, on the scale `alloc_before_p' uses:
+   references (weighted by loop depth) per unit of lifetime and size.
+   NEXT_MEMBER links the members of the group.  */
+
+static double
+group_spill_cost (group, next_member)
+     int group;
+     int *next_member;
+{
+  register int i;
+  double cost = 0;
+
+  for (i = group; i >= 0; i = next_member[i])
+    {
+      register int r = allocno_reg[i];
+      cost += ((double) (floor_log2 (reg_n_refs[r]) * reg_n_refs[r])
+	       / (reg_live_length[r] * allocno_size[i]));
+    }
+  return cost;
+}
+
+/* Allocate the allocnos by coloring the conflict graph
+   (the -fcolor-regs alternative to allocating in priority order).
+
+   First, copies from one allocno to another that do not conflict are
+   coalesced: both allocnos are put in one group that will get one
+   hard reg, making the copy a no-op.  This is done only if it cannot
+   make the group hard to color, by the test of Briggs: the group must
+   have fewer neighbors of high degree than it has registers available.
+
+   Then the groups are simplified: a group with fewer conflicting
+   registers than available registers is taken out of the graph and
+   put on a stack, since it can surely be colored whatever its
+   neighbors get.  When no such group remains, the group whose
+   spill would cost least relative to its degree is taken out
+   anyway, optimistically.  Then the groups are popped off the stack
+   and each is given a hard reg by `find_reg'.  A group that cannot
+   get one is split up and its allocnos tried one by one;
+   any that still fail are left for reload, as before.
+
+   FILE is the dump file, or zero.  */
+
+static void
+color_allocnos (file)
+     FILE *file;
+{
+  register int i, j, k;
+  register rtx insn;
+  int *leader = (int *) alloca (max_allocno * sizeof (int));
+  int *next_member = (int *) alloca (max_allocno * sizeof (int));
+  int *stamp = (int *) alloca (max_allocno * sizeof (int));
+  int *degree = (int *) alloca (max_allocno * sizeof (int));
+  int *avail = (int *) alloca (max_allocno * sizeof (int));
+  int *stack = (int *) alloca (max_allocno * sizeof (int));
+  int *worklist = (int *) alloca (2 * max_allocno * sizeof (int));
+  int *remaining = (int *) alloca (max_allocno * sizeof (int));
+  char *removed = (char *) alloca (max_allocno);
+  int *group_index, *group_vec;
+  int n_stack = 0, n_work = 0, n_remaining = 0;
+  int visit = max_allocno;
+  int n_groups = 0, n_moves = 0, n_coalesced = 0;
+  int n_optimistic = 0, n_split = 0, n_uncolored = 0;
+
+  /* Coloring needs each allocno's list of neighbors.  */
+
+  if (conflicts != 0)
+    conflict_vec_from_matrix ();
+
+  for (i = 0; i < max_allocno; i++)
+    {
+      leader[i] = i;
+      next_member[i] = -1;
+      stamp[i] = -1;
+      avail[i] = allocno_avail_regs (i);
+      degree[i] = 0;
+      for (k = conflict_index[i]; k < conflict_index[i + 1]; k++)
+	if (conflict_vec[k] != i)
+	  degree[i] += allocno_size[conflict_vec[k]];
+    }
+
+  /* Coalesce copies between allocnos, conservatively.  */
+
+  for (insn = get_insns (); insn; insn = NEXT_INSN (insn))
+    if (GET_CODE (insn) == INSN
+	&& GET_CODE (PATTERN (insn)) == SET
+	&& GET_CODE (SET_DEST (PATTERN (insn))) == REG
+	&& GET_CODE (SET_SRC (PATTERN (insn))) == REG)
+      {
+	int r1 = REGNO (SET_DEST (PATTERN (insn)));
+	int r2 = REGNO (SET_SRC (PATTERN (insn)));
+	register int g1, g2;
+	int units, significant;
+
+	if (r1 < FIRST_PSEUDO_REGISTER || r2 < FIRST_PSEUDO_REGISTER
+	    || reg_allocno[r1] < 0 || reg_allocno[r2] < 0
+	    || PSEUDO_REGNO_MODE (r1) != PSEUDO_REGNO_MODE (r2)
+	    || reg_preferred_class (r1) != reg_preferred_class (r2))
+	  continue;
+
+	g1 = leader[reg_allocno[r1]];
+	g2 = leader[reg_allocno[r2]];
+	if (g1 == g2)
+	  continue;
+	n_moves++;
+
+	/* Find the distinct groups that conflict with either group,
+	   totaling their sizes, and the sizes of those of high degree.
+	   If one of them is the other group, the two conflict.
+	   STAMP[N] == VISIT marks group N as already counted.  */
+
+	units = 0;
+	significant = 0;
+	visit++;
+	for (j = g1; j >= 0; j = (j == g1 ? g2 : -1))
+	  for (i = j; i >= 0; i = next_member[i])
+	    for (k = conflict_index[i]; k < conflict_index[i + 1]; k++)
+	      {
+		register int n = leader[conflict_vec[k]];
+		if (n == g1 || n == g2)
+		  {
+		    if (conflict_vec[k] != i)
+		      goto no_coalesce;
+		    continue;
+		  }
+		if (stamp[n] == visit)
+		  continue;
+		stamp[n] = visit;
+		units += allocno_size[n];
+		if (degree[n] + allocno_size[n] > avail[n])
+		  significant += allocno_size[n];
+	      }
+
+	if (significant + allocno_size[g1] > MIN (avail[g1], avail[g2]))
+	  goto no_coalesce;
+
+	/* Put all the members of G2 into G1.  */
+	for (i = g2; ; i = next_member[i])
+	  {
+	    leader[i] = g1;
+	    if (next_member[i] < 0)
+	      break;
+	  }
+	next_member[i] = next_member[g1];
+	next_member[g1] = g2;
+	degree[g1] = units;
+	avail[g1] = MIN (avail[g1], avail[g2]);
+	n_coalesced++;
+
+	if (file)
+	  fprintf (file, ";; Coalescing reg %d with reg %d.\n", r2, r1);
+
+      no_coalesce: ;
+      }
+
+  /* Make the graph of the groups: GROUP_INDEX and GROUP_VEC
+     say which groups conflict with each group, as conflict_index
+     and conflict_vec do for allocnos.  */
+
+  group_index = (int *) xmalloc ((max_allocno + 1) * sizeof (int));
+  group_vec
+    = (int *) xmalloc ((conflict_index[max_allocno] + 1) * sizeof (int));
+
+  k = 0;
+  for (j = 0; j < max_allocno; j++)
+    {
+      group_index[j] = k;
+      if (leader[j] != j)
+	continue;
+      n_groups++;
+      degree[j] = 0;
+      stamp[j] = j;
+      for (i = j; i >= 0; i = next_member[i])
+	{
+	  register int m;
+	  for (m = conflict_index[i]; m < conflict_index[i + 1]; m++)
+	    {
+	      register int n = leader[conflict_vec[m]];
+	      if (stamp[n] != j)
+		{
+		  stamp[n] = j;
+		  group_vec[k++] = n;
+		  degree[j] += allocno_size[n];
+		}
+	    }
+	}
+    }
+  group_index[max_allocno] = k;
+
+  /* Simplify.  Take the groups in priority order, so that
+     among equals the important ones are colored first.  */
+
+  for (i = 0; i < max_allocno; i++)
+    {
+      j = allocno_order[i];
+      removed[j] = 0;
+      if (leader[j] != j)
+	continue;
+      remaining[n_remaining++] = j;
+      if (degree[j] + allocno_size[j] <= avail[j])
+	worklist[n_work++] = j;
+    }
+
+  while (n_stack < n_groups)
+    {
+      register int g;
+
+      if (n_work > 0)
+	g = worklist[--n_work];
+      else
+	{
+	  /* Every group left has too many neighbors.
+	     Choose the one whose spilling would cost least
+	     for the neighbors it would free, and push it anyway.  */
+	  double best_cost = 0;
+
+	  g = -1;
+	  for (i = 0, k = 0; i < n_remaining; i++)
+	    {
+	      register int r = remaining[i];
+	      double cost;
+	      if (removed[r])
+		continue;
+	      remaining[k++] = r;
+	      cost = group_spill_cost (r, next_member) / (degree[r] + 1);
+	      if (g < 0 || cost < best_cost)
+		{
+		  g = r;
+		  best_cost = cost;
+		}
+	    }
+	  n_remaining = k;
+	  n_optimistic++;
+	}
+
+      if (removed[g])
+	continue;
+      removed[g] = 1;
+      stack[n_stack++] = g;
+
+      for (k = group_index[g]; k < group_index[g + 1]; k++)
+	{
+	  register int n = group_vec[k];
+	  if (removed[n])
+	    continue;
+	  if (degree[n] + allocno_size[n] > avail[n]
+	      && degree[n] - allocno_size[g] + allocno_size[n] <= avail[n])
+	    worklist[n_work++] = n;
+	  degree[n] -= allocno_size[g];
+	}
+    }
+
+  /* Select.  Give each group a hard reg, last simplified first.  */
+
+  while (n_stack > 0)
+    {
+      register int g = stack[--n_stack];
+      register int regno = allocno_reg[g];
+      HARD_REG_SET saved_conflicts;
+
+      if (next_member[g] < 0)
+	{
+	  if (N_REG_CLASSES > 1)
+	    find_reg (g, 0, 0);
+	  if (reg_renumber[regno] < 0)
+	    find_reg (g, 0, 1);
+	  if (reg_renumber[regno] < 0)
+	    n_uncolored++;
+	  continue;
+	}
+
+      /* The register must suit every member of the group.
+	 Widen G's own conflicts only while choosing it.  */
+      COPY_HARD_REG_SET (saved_conflicts, hard_reg_conflicts[g]);
+      for (i = next_member[g]; i >= 0; i = next_member[i])
+	{
+	  IOR_HARD_REG_SET (hard_reg_conflicts[g], hard_reg_conflicts[i]);
+	  if (reg_crosses_call[allocno_reg[i]] && ! reg_crosses_call[regno])
+	    IOR_HARD_REG_SET (hard_reg_conflicts[g], call_clobbered_reg_set);
+	}
+
+      if (N_REG_CLASSES > 1)
+	find_reg (g, 0, 0);
+      if (reg_renumber[regno] < 0)
+	find_reg (g, 0, 1);
+      COPY_HARD_REG_SET (hard_reg_conflicts[g], saved_conflicts);
+
+      if (reg_renumber[regno] >= 0)
+	for (i = next_member[g]; i >= 0; i = next_member[i])
+	  assign_allocno_reg (i, reg_renumber[regno]);
+      else
+	{
+	  /* The group as a whole lost; try its members separately.  */
+	  n_split++;
+	  for (i = g; i >= 0; i = next_member[i])
+	    {
+	      if (N_REG_CLASSES > 1)
+		find_reg (i, 0, 0);
+	      if (reg_renumber[allocno_reg[i]] < 0)
+		find_reg (i, 0, 1);
+	      if (reg_renumber[allocno_reg[i]] < 0)
+		n_uncolored++;
+	    }
+	}
+    }
+
+  if (file)
+    fprintf (file, ";; Coloring: %d groups, %d of %d copies coalesced, %d pushed optimistically,\n;; %d groups split, %d regs not colored.\n\n",
+	     n_groups, n_coalesced, n_moves, n_optimistic, n_split,
+	     n_uncolored);
+
+  free (group_index);
+  free (group_vec);
+}
+
 /* Return nonzero if register number REGNO
    is one of the "dead registers" of INSN.
    If this is true for one of the regs set by INSN,
@@ -760,6 +1375,22 @@ dump_conflicts (file)
      FILE *file;
 {
   register int i;
+
+  /* In the bit matrix, the edges have not been counted.  */
+  if (conflicts != 0)
+    for (i = 0; i < max_allocno; i++)
+      {
+	register int j;
+	for (j = i + 1; j < max_allocno; j++)
+	  if (CONFLICTP (i, j) || CONFLICTP (j, i))
+	    conflict_edges++;
+      }
+
+  fprintf (file, ";; %d allocnos, %d conflicts, %s of %d bytes.\n\n",
+	   max_allocno, conflict_edges,
+	   conflicts != 0 ? "bit matrix" : "hashed conflict graph",
+	   conflict_bytes);
+
   fprintf (file, ";; %d regs to allocate:", max_allocno);
   for (i = 0; i < max_allocno; i++)
     {
@@ -774,9 +1405,13 @@ dump_conflicts (file)
       register int j;
       fprintf (file, ";; %d conflicts:", allocno_reg[i],
 	       reg_renumber[allocno_reg[i]]);
-      for (j = 0; j < max_allocno; j++)
-	if (CONFLICTP (i, j) || CONFLICTP (j, i))
-	  fprintf (file, " %d", allocno_reg[j]);
+      if (conflicts == 0)
+	for (j = conflict_index[i]; j < conflict_index[i + 1]; j++)
+	  fprintf (file, " %d", allocno_reg[conflict_vec[j]]);
+      else
+	for (j = 0; j < max_allocno; j++)
+	  if (CONFLICTP (i, j) || CONFLICTP (j, i))
+	    fprintf (file, " %d", allocno_reg[j]);
       for (j = 0; j < FIRST_PSEUDO_REGISTER; j++)
 	if (TEST_HARD_REG_BIT (hard_reg_conflicts[i], j))
 	  fprintf (file, " %d", j);
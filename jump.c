@@ -36,23 +36,45 @@ and this notice must be preserved on all copies.  */
    formerly used them.  The JUMP_LABEL info is sometimes looked
    at by later passes.
 
+   We also keep, for each CODE_LABEL, a chain of the jump insns
+   that refer to it.  These are the edges of the flow graph that
+   reach the label by jumping rather than by falling into it;
+   a jump's own outgoing edges are its JUMP_LABEL (or the labels
+   of its ADDR_VEC) and, if it is conditional, the next insn.
+   The chains are built here and kept up to date by delete_insn,
+   redirect_jump and invert_jump, so that later passes can ask
+   which jumps reach a label (`jumps_to_label') instead of
+   scanning every jump in the function.
+
    Optionally, cross-jumping can be done.  Currently it is done
    only the last time (when after reload and before final).
    In fact, the code for cross-jumping now assumes that register
-   allocation has been done, since it uses `rtx_renumbered_equal_p'.
+   allocation has been done, since it compares insns as they will be
+   after each pseudo reg is renumbered to its hard reg.
+   Each insn is given a hash code that ignores register numbers,
+   so most mismatches are found without comparing the insns,
+   and unconditional jumps to the same label whose preceding code
+   may match are paired up by looking up that code's hash in a table.
 
    Jump optimization is done after cse when cse's constant-propagation
    causes jumps to become unconditional or to be deleted.
 
+   Before the other optimizations, conditional jumps are threaded:
+   a conditional jump to a label where the same comparison is made
+   again, followed by another conditional jump, is redirected to
+   wherever the second jump is then known to go.  See `thread_jumps'.
+
    Unreachable loops are not detected here, because the labels
    have references and the insns appear reachable from the labels.
    find_basic_blocks in flow.c finds and deletes such loops.
 
-   The subroutines delete_insn, redirect_jump, invert_jump, next_real_insn
-   and prev_real_insn are used from other passes as well.  */
+   The subroutines delete_insn, redirect_jump, invert_jump, next_real_insn,
+   prev_real_insn and jumps_to_label are used from other passes as well.  */
 
 #include "config.h"
 #include "rtl.h"
+#include "regs.h"
+#include <stdio.h>
 
 /* ??? Eventually must record somehow the labels used by jumps
    from nested functions.  */
@@ -72,14 +94,109 @@ void redirect_jump ();
 void invert_jump ();
 rtx next_real_insn ();
 rtx prev_real_insn ();
+rtx jumps_to_label ();
 
+extern int xmalloc ();
+extern int xrealloc ();
+extern void free ();
+
+static void init_label_jump_chains ();
+static rtx *label_jump_chain_slot ();
+static void chain_jump_labels ();
 static void mark_jump_label ();
 static void delete_jump ();
 static void invert_exp ();
 static void redirect_exp ();
 static rtx follow_jumps ();
 static int tension_vector_labels ();
+static int do_cross_jump ();
 static void find_cross_jump ();
+static int cross_jump_tails ();
+static unsigned insn_hash ();
+static unsigned cross_jump_rtx_hash ();
+static unsigned cross_jump_tail_hash ();
+static int cross_jump_equal_p ();
+static int cross_jump_reg_mentioned_p ();
+static int cross_jump_reg_dead_p ();
+static int cross_jump_reg_used_between_p ();
+static int simplejump_p ();
+static int condjump_p ();
+static void thread_jumps ();
+static int thread_jump ();
+static rtx cc0_jump_compare ();
+static int cc0_jump_outcomes ();
+static int thread_side_effects_p ();
+
+/* Number of the last CODE_LABEL made, plus one (in emit-rtl.c).  */
+
+extern int label_no;
+
+/* Indexed by CODE_LABEL_NUMBER minus `first_chained_label',
+   an INSN_LIST chain of the jump insns that refer to that label.
+   A jump appears once for each LABEL_REF to the label in its pattern.
+   A jump that has been turned into a NOTE in place, without using
+   delete_insn, may remain on the chains; users must check the code.  */
+
+static rtx *label_jump_chain;
+
+/* Number of elements allocated in `label_jump_chain'.  */
+
+static int label_jump_chain_size;
+
+/* Lowest label number that `label_jump_chain' covers.
+   Labels are numbered in order of creation over the whole compilation,
+   so every label of the current function is at least this.  */
+
+static int first_chained_label;
+
+/* Indexed by INSN_UID, the hash code of each insn for cross-jumping,
+   computed by `insn_hash' when first needed; zero if not yet known.
+   Allocated only while jump_optimize is cross-jumping.  */
+
+static unsigned *cross_jump_hash;
+
+/* Number of elements in `cross_jump_hash'.  */
+
+static int cross_jump_max_uid;
+
+/* The pair table of `find_cross_jump'.  For a hard reg I of the first
+   stream of insns that corresponds to a different hard reg of the
+   second stream, cross_jump_pair[I] is that reg, and
+   cross_jump_pair_of[that reg] is I.  Otherwise each is -1.  */
+
+static short cross_jump_pair[FIRST_PSEUDO_REGISTER];
+static short cross_jump_pair_of[FIRST_PSEUDO_REGISTER];
+
+/* Number of pairs now in the pair table.  */
+
+static int cross_jump_n_pairs;
+
+/* Pairs entered in the table while comparing the current insns,
+   as regnos of the first stream.  */
+
+static short cross_jump_new_pairs[FIRST_PSEUDO_REGISTER];
+static int cross_jump_n_new_pairs;
+
+/* Number of conditional jumps threaded by `thread_jumps'
+   in the last call to jump_optimize, and in the whole compilation.  */
+
+static int jump_threads;
+static int total_jump_threads;
+
+/* Indexed by CODE_LABEL_NUMBER minus `first_chained_label',
+   the first real insn after each label, for `thread_jumps'.
+   Zero for a label made since the table was built.  */
+
+static rtx *label_first_insn;
+
+/* Number of elements in `label_first_insn'.  */
+
+static int label_first_insn_size;
+
+/* Nonzero for registers that are never available for other uses;
+   these are never renamed by cross-jumping.  */
+
+static char fixed_regs[] = FIXED_REGISTERS;
 
 /* Delete no-op jumps and optimize jumps to jumps
    and jumps around jumps.
@@ -94,6 +211,19 @@ jump_optimize (f, cross_jump)
   register rtx insn;
   int changed;
 
+  /* Make room for the hash codes of the insns, for cross-jumping.  */
+
+  if (cross_jump)
+    {
+      cross_jump_max_uid = 0;
+      for (insn = f; insn; insn = NEXT_INSN (insn))
+	if (INSN_UID (insn) >= cross_jump_max_uid)
+	  cross_jump_max_uid = INSN_UID (insn) + 1;
+      cross_jump_hash
+	= (unsigned *) xmalloc (cross_jump_max_uid * sizeof (unsigned));
+      bzero (cross_jump_hash, cross_jump_max_uid * sizeof (unsigned));
+    }
+
   /* Initialize LABEL_NUSES and JUMP_LABEL fields.  */
 
   for (insn = f; insn; insn = NEXT_INSN (insn))
@@ -120,7 +250,9 @@ jump_optimize (f, cross_jump)
 	}
 
   /* Mark the label each jump jumps to.
-     Count uses of CODE_LABELs.  */
+     Count uses of CODE_LABELs and chain each jump onto its labels.  */
+
+  init_label_jump_chains (f);
 
   for (insn = f; insn; insn = NEXT_INSN (insn))
     if (GET_CODE (insn) == JUMP_INSN)
@@ -128,6 +260,11 @@ jump_optimize (f, cross_jump)
 	mark_jump_label (PATTERN (insn), insn);
       }
 
+  /* Thread conditional jumps through repeated comparisons.
+     This leaves unused labels for the next step to delete.  */
+
+  thread_jumps (f);
+
   /* Delete all labels already not referenced.  */
 
   for (insn = f; insn; )
@@ -154,9 +291,9 @@ jump_optimize (f, cross_jump)
 	  if (GET_CODE (insn) == JUMP_INSN)
 	    {
 	      if (GET_CODE (PATTERN (insn)) == ADDR_VEC)
-		changed |= tension_vector_labels (PATTERN (insn), 0);
+		changed |= tension_vector_labels (insn, 0);
 	      if (GET_CODE (PATTERN (insn)) == ADDR_DIFF_VEC)
-		changed |= tension_vector_labels (PATTERN (insn), 1);
+		changed |= tension_vector_labels (insn, 1);
 	    }
 	  if (GET_CODE (insn) == JUMP_INSN && JUMP_LABEL (insn))
 	    {
@@ -205,82 +342,188 @@ jump_optimize (f, cross_jump)
 		  /* Now that the jump has been tensioned,
 		     try cross jumping: check for identical code
 		     before the jump and before its target label. */
-		  if (cross_jump && condjump_p (insn))
+		  if (cross_jump && condjump_p (insn)
+		      && do_cross_jump (insn, JUMP_LABEL (insn),
+					(simplejump_p (insn)
+					 ? JUMP_LABEL (insn) : 0)))
 		    {
-		      rtx newjpos, newlpos;
-
-		      find_cross_jump (insn, JUMP_LABEL (insn),
-				       &newjpos, &newlpos);
-		      if (newjpos != 0)
-			{
-			  register rtx label;
-			  /* Find an existing label at this point
-			     or make a new one if there is none.  */
-			  label = PREV_INSN (newlpos);
-			  if (GET_CODE (label) != CODE_LABEL)
-			    {
-			      label = gen_label_rtx ();
-			      emit_label_after (label, PREV_INSN (newlpos));
-			      LABEL_NUSES (label) = 0;
-			    }
-			  /* Make the same jump insn jump to the new point.  */
-			  redirect_jump (insn, label);
-			  /* Delete the matching insns before the jump.  */
-			  newjpos = PREV_INSN (newjpos);
-			  while (NEXT_INSN (newjpos) != insn)
-			    /* Don't delete line numbers.  */
-			    if (GET_CODE (NEXT_INSN (newjpos)) != NOTE)
-			      delete_insn (NEXT_INSN (newjpos));
-			    else
-			      newjpos = NEXT_INSN (newjpos);
-			  changed = 1;
-			  next = insn;
-			}
+		      changed = 1;
+		      next = insn;
 		    }
 		}
 	    }
 	}
+
+      /* Cross-jump between unconditional jumps to the same label.  */
+      if (cross_jump)
+	changed |= cross_jump_tails (f);
+    }
+
+  if (cross_jump)
+    {
+      free (cross_jump_hash);
+      cross_jump_hash = 0;
     }
 }
+
+/* Try to cross-jump JUMP with E2, which is either JUMP's target label
+   or an unconditional jump to that label.  If the code before JUMP
+   matches the code before E2, make JUMP jump to the start of the code
+   before E2 and delete the code before JUMP.  AFTER, if nonzero, is the
+   label that control reaches from both; it permits `find_cross_jump'
+   to rename registers.  Return nonzero if anything was changed.  */
+
+static int
+do_cross_jump (jump, e2, after)
+     rtx jump, e2, after;
+{
+  rtx newjpos, newlpos;
+  register rtx label;
+
+  find_cross_jump (jump, e2, after, &newjpos, &newlpos);
+  if (newjpos == 0)
+    return 0;
+
+  /* Find an existing label at this point
+     or make a new one if there is none.  */
+  label = PREV_INSN (newlpos);
+  if (GET_CODE (label) != CODE_LABEL)
+    {
+      label = gen_label_rtx ();
+      emit_label_after (label, PREV_INSN (newlpos));
+      LABEL_NUSES (label) = 0;
+    }
+  /* Make the same jump insn jump to the new point.  */
+  redirect_jump (jump, label);
+  /* Delete the matching insns before the jump.  */
+  newjpos = PREV_INSN (newjpos);
+  while (NEXT_INSN (newjpos) != jump)
+    /* Don't delete line numbers.  */
+    if (GET_CODE (NEXT_INSN (newjpos)) != NOTE)
+      delete_insn (NEXT_INSN (newjpos));
+    else
+      newjpos = NEXT_INSN (newjpos);
+  return 1;
+}
+
+/* Look for unconditional jumps to one label that are preceded by
+   matching code, and cross-jump each such jump with the first of them.
+   The code before each jump is hashed by `cross_jump_tail_hash',
+   and the jumps are entered in a hash table by label and hash code;
+   only jumps that meet in the table are compared.
+   Return nonzero if anything was changed.  */
+
+static int
+cross_jump_tails (f)
+     rtx f;
+{
+  register rtx insn;
+  register int i;
+  register unsigned hash;
+  rtx *table;
+  unsigned *table_hash;
+  int size = 1;
+  int changed = 0;
+
+  for (insn = f; insn; insn = NEXT_INSN (insn))
+    if (GET_CODE (insn) == JUMP_INSN && JUMP_LABEL (insn) != 0
+	&& simplejump_p (insn))
+      size += 2;
+
+  table = (rtx *) alloca (size * sizeof (rtx));
+  table_hash = (unsigned *) alloca (size * sizeof (unsigned));
+  bzero (table, size * sizeof (rtx));
+
+  for (insn = f; insn; insn = NEXT_INSN (insn))
+    {
+      if (GET_CODE (insn) != JUMP_INSN || JUMP_LABEL (insn) == 0
+	  || ! simplejump_p (insn))
+	continue;
+
+      /* Look for an earlier jump whose code matches the code
+	 before this one.  */
+      hash = cross_jump_tail_hash (insn, 0);
+      if (hash != 0)
+	{
+	  hash = hash * 1009 + INSN_UID (JUMP_LABEL (insn));
+	  for (i = hash % size; table[i] != 0; i = (i + 1) % size)
+	    if (table_hash[i] == hash
+		&& JUMP_LABEL (table[i]) == JUMP_LABEL (insn))
+	      break;
+	  if (table[i] != 0)
+	    {
+	      if (do_cross_jump (insn, table[i], JUMP_LABEL (insn)))
+		changed = 1;
+	      continue;
+	    }
+	}
+
+      /* There is none, so later jumps may match this one.  */
+      hash = cross_jump_tail_hash (insn, 1);
+      if (hash != 0)
+	{
+	  hash = hash * 1009 + INSN_UID (JUMP_LABEL (insn));
+	  for (i = hash % size; table[i] != 0; i = (i + 1) % size)
+	    if (table_hash[i] == hash
+		&& JUMP_LABEL (table[i]) == JUMP_LABEL (insn))
+	      break;
+	  if (table[i] == 0)
+	    {
+	      table[i] = insn;
+	      table_hash[i] = hash;
+	    }
+	}
+    }
+
+  return changed;
+}
 
 /* Compare the instructions before insn E1 with those before E2.
    Find the longest possible equivalent sequences
    and store the first insns of those sequences into *F1 and *F2.
    Store zero there if no equivalent preceding instructions are found.
 
+   If AFTER is nonzero, it is the label to which control goes
+   from the end of both sequences, and nowhere else.
+   Then registers may be renamed, as follows.
+
+   Scan backward one insn at a time
+   and maintain the pair table as showing all corresponding
+   registers that are not the same number.
+   Pairs are inserted when the two insns being compared
+   use different registers.
+   Pairs are removed when we find two insns being compared
+   each setting the appropriate member of the pair.
+   Any other differences disqualify the insns, and we stop.
+   When the pair table is empty after scanning an insn,
+   that insn is the beginning of a sequence of equivalent insns.
+
+   The pair table is incorrect if anything after AFTER
+   refers to those mismatched registers (that is, if they aren't really
+   temps), so a pair is inserted only if both regs are set at AFTER
+   before they are used.  Nor may either reg of a pair appear
+   anywhere else in the sequences while the pair is in the table,
+   or in the insns already matched.
+
    We give up if we find a label in stream 1.
    Actually we could transfer that label into stream 2.  */
 
 static void
-find_cross_jump (e1, e2, f1, f2)
-     rtx e1, e2;
+find_cross_jump (e1, e2, after, f1, f2)
+     rtx e1, e2, after;
      rtx *f1, *f2;
 {
   register rtx i1 = e1, i2 = e2;
   register rtx p1, p2;
-  int had_pairs = 0;
+  register int i, r1, r2;
   int nontrivial = 0;
 
   *f1 = 0;
   *f2 = 0;
 
-  /* This is how it really should work:
-
-     Scan backward one insn at a time
-     and maintain the pair table as showing all corresponding
-     registers that are not the same number.
-     Pairs are inserted when the two insns being compared
-     use different registers.
-     Pairs are removed when we find two insns being compared
-     each setting the appropriate member of the pair.
-     Any other differences disqualify the insns, and we stop.
-     When the pair table is empty after scanning an insn,
-     that insn is the beginning of a sequence of equivalent insns.
-
-     But what we really do is give up on any sign of a mismatch.
-     We can't make the pair-table win because it is incorrect
-     if anything AFTER the original label (E2) refers to those
-     mismatched registers.  (That is, if they aren't really temps.)  */
+  for (i = 0; i < FIRST_PSEUDO_REGISTER; i++)
+    cross_jump_pair[i] = cross_jump_pair_of[i] = -1;
+  cross_jump_n_pairs = 0;
 
   while (1)
     {
@@ -312,17 +555,728 @@ find_cross_jump (e1, e2, f1, f2)
       if (GET_CODE (p1) != GET_CODE (p2))
 	break;
 
-      if (!rtx_renumbered_equal_p (p1, p2))
+      /* Most mismatches show up in the hash codes.  */
+      if (insn_hash (i1) != insn_hash (i2))
+	break;
+
+      cross_jump_n_new_pairs = 0;
+      if (!cross_jump_equal_p (p1, p2, after != 0))
 	break;
 
+      /* A new pair is valid only if neither reg is live at AFTER
+	 or used in the insns already matched.  */
+      for (i = 0; i < cross_jump_n_new_pairs; i++)
+	{
+	  r1 = cross_jump_new_pairs[i];
+	  r2 = cross_jump_pair[r1];
+	  if (! cross_jump_reg_dead_p (r1, after)
+	      || ! cross_jump_reg_dead_p (r2, after)
+	      || cross_jump_reg_used_between_p (r1, i1, e1)
+	      || cross_jump_reg_used_between_p (r2, i1, e1)
+	      || cross_jump_reg_used_between_p (r1, i2, e2)
+	      || cross_jump_reg_used_between_p (r2, i2, e2))
+	    break;
+	}
+      if (i < cross_jump_n_new_pairs)
+	break;
+
+      /* Neither reg of a pair may appear in the other stream
+	 in any other role.  */
+      for (r1 = 0; r1 < FIRST_PSEUDO_REGISTER; r1++)
+	if (cross_jump_pair[r1] >= 0
+	    && (cross_jump_reg_mentioned_p (cross_jump_pair[r1], p1)
+		|| cross_jump_reg_mentioned_p (r1, p2)))
+	  break;
+      if (r1 < FIRST_PSEUDO_REGISTER)
+	break;
+
+      /* If these insns set the regs of a pair from values that do not
+	 involve them, the values they had before are of no interest.  */
+      if (cross_jump_n_pairs > 0 && GET_CODE (p1) == SET
+	  && GET_CODE (SET_DEST (p1)) == REG)
+	{
+	  r1 = REGNO (SET_DEST (p1));
+	  if (r1 >= FIRST_PSEUDO_REGISTER)
+	    r1 = reg_renumber[r1];
+	  if (r1 >= 0 && r1 < FIRST_PSEUDO_REGISTER
+	      && cross_jump_pair[r1] >= 0
+	      && ! cross_jump_reg_mentioned_p (r1, SET_SRC (p1)))
+	    {
+	      cross_jump_pair_of[cross_jump_pair[r1]] = -1;
+	      cross_jump_pair[r1] = -1;
+	      cross_jump_n_pairs--;
+	    }
+	}
+
       if (GET_CODE (p1) != USE && GET_CODE (p1) != CLOBBER)
 	nontrivial = 1;
 
-      if (nontrivial)
+      if (nontrivial && cross_jump_n_pairs == 0)
 	*f1 = i1, *f2 = i2;
     }
 }
+
+/* Return the hash code of INSN for cross-jumping.
+   Insns that `cross_jump_equal_p' may find equal have equal hash codes,
+   so register numbers do not enter into it.  */
+
+static unsigned
+insn_hash (insn)
+     rtx insn;
+{
+  register int uid = INSN_UID (insn);
+  register unsigned hash;
+
+  if (uid < cross_jump_max_uid && cross_jump_hash[uid] != 0)
+    return cross_jump_hash[uid];
+
+  hash = cross_jump_rtx_hash (PATTERN (insn));
+  if (hash == 0)
+    hash = 1;
+  if (uid < cross_jump_max_uid)
+    cross_jump_hash[uid] = hash;
+  return hash;
+}
+
+/* Compute a hash code for rtx X that does not depend on
+   the numbers or modes of any registers in it.  */
+
+static unsigned
+cross_jump_rtx_hash (x)
+     rtx x;
+{
+  register RTX_CODE code = GET_CODE (x);
+  register unsigned hash = (unsigned) code;
+  register int i, j;
+  register char *fmt;
+  register char *p;
+
+  if (code == REG || (code == SUBREG && GET_CODE (SUBREG_REG (x)) == REG))
+    return (unsigned) REG;
+  if (code == LABEL_REF)
+    return hash * 31 + INSN_UID (XEXP (x, 0));
+  if (code == SYMBOL_REF)
+    {
+      for (p = XSTR (x, 0); *p; p++)
+	hash = hash * 31 + *p;
+      return hash;
+    }
+
+  hash = hash * 31 + (unsigned) GET_MODE (x);
+
+  fmt = GET_RTX_FORMAT (code);
+  for (i = GET_RTX_LENGTH (code) - 1; i >= 0; i--)
+    {
+      if (fmt[i] == 'e')
+	hash = hash * 31 + cross_jump_rtx_hash (XEXP (x, i));
+      else if (fmt[i] == 'E')
+	for (j = 0; j < XVECLEN (x, i); j++)
+	  hash = hash * 31 + cross_jump_rtx_hash (XVECEXP (x, i, j));
+      else if (fmt[i] == 'i')
+	hash = hash * 31 + XINT (x, i);
+    }
+  return hash;
+}
+
+/* Return a hash code for the code before JUMP, made from the hash codes
+   of the insns back to and including the last one that is not a USE
+   or CLOBBER.  These are the insns that must match for a cross-jump.
+   Return zero if a CODE_LABEL, BARRIER or jump comes first; but if
+   SKIP_LABELS is nonzero, ignore labels, as the second stream of
+   `find_cross_jump' does.  */
+
+static unsigned
+cross_jump_tail_hash (jump, skip_labels)
+     rtx jump;
+     int skip_labels;
+{
+  register rtx insn = jump;
+  register unsigned hash = 0;
+  register RTX_CODE code;
+
+  while (1)
+    {
+      insn = PREV_INSN (insn);
+      while (insn != 0
+	     && (GET_CODE (insn) == NOTE
+		 || (skip_labels && GET_CODE (insn) == CODE_LABEL)))
+	insn = PREV_INSN (insn);
+
+      if (insn == 0)
+	return 0;
+      code = GET_CODE (insn);
+      if (code != INSN && code != CALL_INSN)
+	return 0;
+
+      hash = hash * 1009 + insn_hash (insn);
+      code = GET_CODE (PATTERN (insn));
+      if (code != USE && code != CLOBBER)
+	return hash == 0 ? 1 : hash;
+    }
+}
+
+/* Like rtx_renumbered_equal_p, but if RENAME is nonzero,
+   a hard reg in X may correspond to a different hard reg in Y.
+   Each such correspondence is a pair in the pair table of
+   `find_cross_jump'; a reg in a pair must correspond to its partner,
+   and a new pair is also recorded in `cross_jump_new_pairs'.  */
+
+static int
+cross_jump_equal_p (x, y, rename)
+     rtx x, y;
+     int rename;
+{
+  register int i, j;
+  register RTX_CODE code = GET_CODE (x);
+  register char *fmt;
+
+  if (x == y)
+    return 1;
+  if ((code == REG || (code == SUBREG && GET_CODE (SUBREG_REG (x)) == REG))
+      && (GET_CODE (y) == REG || (GET_CODE (y) == SUBREG
+				  && GET_CODE (SUBREG_REG (y)) == REG)))
+    {
+      if (code == SUBREG)
+	{
+	  i = REGNO (SUBREG_REG (x));
+	  if (reg_renumber[i] >= 0)
+	    i = reg_renumber[i];
+	  i += SUBREG_WORD (x);
+	}
+      else
+	{
+	  i = REGNO (x);
+	  if (reg_renumber[i] >= 0)
+	    i = reg_renumber[i];
+	}
+      if (GET_CODE (y) == SUBREG)
+	{
+	  j = REGNO (SUBREG_REG (y));
+	  if (reg_renumber[j] >= 0)
+	    j = reg_renumber[j];
+	  j += SUBREG_WORD (y);
+	}
+      else
+	{
+	  j = REGNO (y);
+	  if (reg_renumber[j] >= 0)
+	    j = reg_renumber[j];
+	}
+
+      if (i >= FIRST_PSEUDO_REGISTER || j >= FIRST_PSEUDO_REGISTER)
+	return i == j;
+      if (i == j)
+	return cross_jump_pair[i] < 0 && cross_jump_pair_of[i] < 0;
+      if (cross_jump_pair[i] == j)
+	return 1;
+
+      /* Pair only whole regs that each occupy one hard reg.  */
+      if (! rename || code != REG || GET_CODE (y) != REG
+	  || GET_MODE (x) != GET_MODE (y)
+	  || HARD_REGNO_NREGS (i, GET_MODE (x)) != 1
+	  || HARD_REGNO_NREGS (j, GET_MODE (y)) != 1
+	  || fixed_regs[i] || fixed_regs[j]
+	  || cross_jump_pair[i] >= 0 || cross_jump_pair_of[i] >= 0
+	  || cross_jump_pair[j] >= 0 || cross_jump_pair_of[j] >= 0)
+	return 0;
+
+      cross_jump_pair[i] = j;
+      cross_jump_pair_of[j] = i;
+      cross_jump_n_pairs++;
+      cross_jump_new_pairs[cross_jump_n_new_pairs++] = i;
+      return 1;
+    }
+  if (code != GET_CODE (y))
+    return 0;
+  if (code == LABEL_REF)
+    return XEXP (x, 0) == XEXP (y, 0);
+  if (code == SYMBOL_REF)
+    return XSTR (x, 0) == XSTR (y, 0);
+
+  /* (MULT:SI x y) and (MULT:HI x y) are NOT equivalent.  */
+
+  if (GET_MODE (x) != GET_MODE (y))
+    return 0;
+
+  /* Compare the elements.  If any pair of corresponding elements
+     fail to match, return 0 for the whole things.  */
+
+  fmt = GET_RTX_FORMAT (code);
+  for (i = GET_RTX_LENGTH (code) - 1; i >= 0; i--)
+    {
+      switch (fmt[i])
+	{
+	case 'i':
+	  if (XINT (x, i) != XINT (y, i))
+	    return 0;
+	  break;
+
+	case 'e':
+	  if (cross_jump_equal_p (XEXP (x, i), XEXP (y, i), rename) == 0)
+	    return 0;
+	  break;
+
+	case 'E':
+	  if (XVECLEN (x, i) != XVECLEN (y, i))
+	    return 0;
+	  for (j = 0; j < XVECLEN (x, i); j++)
+	    if (cross_jump_equal_p (XVECEXP (x, i, j), XVECEXP (y, i, j),
+				    rename) == 0)
+	      return 0;
+	  break;
+
+	case '0':
+	  break;
+
+	default:
+	  return 0;
+	}
+    }
+  return 1;
+}
+
+/* Return nonzero if X refers to hard reg REGNO,
+   counting each pseudo reg as the hard reg it was allocated.  */
+
+static int
+cross_jump_reg_mentioned_p (regno, x)
+     int regno;
+     rtx x;
+{
+  register RTX_CODE code = GET_CODE (x);
+  register int i, j;
+  register char *fmt;
+
+  if (code == REG)
+    {
+      i = REGNO (x);
+      if (i >= FIRST_PSEUDO_REGISTER)
+	{
+	  i = reg_renumber[i];
+	  if (i < 0)
+	    return 0;
+	}
+      return regno >= i && regno < i + HARD_REGNO_NREGS (i, GET_MODE (x));
+    }
+
+  fmt = GET_RTX_FORMAT (code);
+  for (i = GET_RTX_LENGTH (code) - 1; i >= 0; i--)
+    {
+      if (fmt[i] == 'e')
+	{
+	  if (cross_jump_reg_mentioned_p (regno, XEXP (x, i)))
+	    return 1;
+	}
+      else if (fmt[i] == 'E')
+	for (j = 0; j < XVECLEN (x, i); j++)
+	  if (cross_jump_reg_mentioned_p (regno, XVECEXP (x, i, j)))
+	    return 1;
+    }
+  return 0;
+}
+
+/* Return nonzero if hard reg REGNO is mentioned in an insn
+   strictly between FROM and TO.  */
+
+static int
+cross_jump_reg_used_between_p (regno, from, to)
+     int regno;
+     rtx from, to;
+{
+  register rtx insn;
+
+  for (insn = NEXT_INSN (from); insn != to; insn = NEXT_INSN (insn))
+    if ((GET_CODE (insn) == INSN || GET_CODE (insn) == CALL_INSN
+	 || GET_CODE (insn) == JUMP_INSN)
+	&& cross_jump_reg_mentioned_p (regno, PATTERN (insn)))
+      return 1;
+  return 0;
+}
+
+/* Return nonzero if hard reg REGNO is certainly dead at LABEL:
+   the insns that follow LABEL in line set it before using it.  */
+
+static int
+cross_jump_reg_dead_p (regno, label)
+     int regno;
+     rtx label;
+{
+  register rtx insn, x;
+  register RTX_CODE code;
+  register int r;
+
+  for (insn = NEXT_INSN (label); insn; insn = NEXT_INSN (insn))
+    {
+      code = GET_CODE (insn);
+      if (code == NOTE || code == CODE_LABEL)
+	continue;
+      if (code != INSN && code != CALL_INSN)
+	return 0;
+
+      x = PATTERN (insn);
+      if (code == INSN && GET_CODE (x) == SET
+	  && GET_CODE (SET_DEST (x)) == REG)
+	{
+	  r = REGNO (SET_DEST (x));
+	  if (r >= FIRST_PSEUDO_REGISTER)
+	    r = reg_renumber[r];
+	  if (r == regno && ! cross_jump_reg_mentioned_p (regno, SET_SRC (x)))
+	    return 1;
+	}
+      if (cross_jump_reg_mentioned_p (regno, x))
+	return 0;
+    }
+  return 0;
+}
 
+/* Jump threading.
+
+   When a conditional jump goes to a label that is followed by the very
+   same comparison and another conditional jump, the condition codes are
+   the same at the second jump as at the first, so whenever the first
+   jump is taken the outcome of the second may be known.  If the
+   condition of the first jump implies that of the second, the first
+   jump can go straight to the second one's label; if it implies the
+   opposite, it can go straight to the insn after the second jump.
+   The second comparison and jump are then skipped on that path.
+
+   This is done for all conditional jumps in a single pass driven by
+   a worklist.  A jump that has been threaded goes back on the list,
+   since its new target may permit threading it further; so do the
+   jumps whose target is the comparison before it, which may now be
+   threaded to its new destination.  The first real insn after each
+   label is found in `label_first_insn' rather than by scanning.  */
+
+static void
+thread_jumps (f)
+     rtx f;
+{
+  register rtx insn, last, next_real;
+  register int i;
+  rtx *worklist;
+  char *on_list;
+  int n_jumps = 0;
+  int max_uid = 0;
+  int steps;
+  int size = label_no - first_chained_label;
+
+  label_first_insn_size = 0;
+
+  jump_threads = 0;
+
+  /* Make the label index, scanning backward from the last insn.  */
+
+  last = 0;
+  for (insn = f; insn; insn = NEXT_INSN (insn))
+    {
+      last = insn;
+      if (INSN_UID (insn) >= max_uid)
+	max_uid = INSN_UID (insn) + 1;
+      if (GET_CODE (insn) == JUMP_INSN)
+	n_jumps++;
+    }
+
+  if (n_jumps == 0)
+    return;
+
+  label_first_insn = (rtx *) alloca (size * sizeof (rtx));
+  label_first_insn_size = size;
+  bzero (label_first_insn, size * sizeof (rtx));
+  next_real = 0;
+  for (insn = last; insn; insn = PREV_INSN (insn))
+    {
+      register RTX_CODE code = GET_CODE (insn);
+      if (code == INSN || code == JUMP_INSN || code == CALL_INSN)
+	next_real = insn;
+      else if (code == CODE_LABEL)
+	{
+	  i = CODE_LABEL_NUMBER (insn) - first_chained_label;
+	  if (i >= 0 && i < size)
+	    label_first_insn[i] = next_real;
+	}
+    }
+
+  /* Put every jump on the worklist, last one on top.  */
+
+  worklist = (rtx *) alloca (n_jumps * sizeof (rtx));
+  on_list = (char *) alloca (max_uid);
+  bzero (on_list, max_uid);
+  n_jumps = 0;
+  for (insn = last; insn; insn = PREV_INSN (insn))
+    if (GET_CODE (insn) == JUMP_INSN)
+      {
+	worklist[n_jumps++] = insn;
+	on_list[INSN_UID (insn)] = 1;
+      }
+
+  /* Each thread skips a comparison on some path, but jumps that loop
+     back to their own comparisons could go on forever; limit the work.  */
+  steps = 4 * n_jumps;
+
+  while (n_jumps > 0 && steps-- > 0)
+    {
+      register rtx jump = worklist[--n_jumps];
+      register rtx compare, link, tem;
+
+      on_list[INSN_UID (jump)] = 0;
+      if (! thread_jump (jump))
+	continue;
+
+      jump_threads++;
+
+      /* Requeue JUMP, and the jumps to labels just before its comparison,
+	 which may now be threaded to where JUMP goes.
+	 (Jumps made since the worklist was made are not requeued.)  */
+
+      if (INSN_UID (jump) < max_uid && ! on_list[INSN_UID (jump)])
+	{
+	  worklist[n_jumps++] = jump;
+	  on_list[INSN_UID (jump)] = 1;
+	}
+
+      compare = cc0_jump_compare (jump);
+      for (tem = PREV_INSN (compare);
+	   tem && (GET_CODE (tem) == CODE_LABEL || GET_CODE (tem) == NOTE);
+	   tem = PREV_INSN (tem))
+	if (GET_CODE (tem) == CODE_LABEL)
+	  for (link = jumps_to_label (tem); link; link = XEXP (link, 1))
+	    {
+	      register rtx other = XEXP (link, 0);
+	      if (GET_CODE (other) == JUMP_INSN
+		  && INSN_UID (other) < max_uid
+		  && ! on_list[INSN_UID (other)])
+		{
+		  worklist[n_jumps++] = other;
+		  on_list[INSN_UID (other)] = 1;
+		}
+	    }
+    }
+
+  total_jump_threads += jump_threads;
+  label_first_insn = 0;
+  label_first_insn_size = 0;
+}
+
+/* If possible, thread the conditional jump JUMP through the
+   comparison and conditional jump at its target label.
+   Return nonzero if JUMP was redirected.  */
+
+static int
+thread_jump (jump)
+     rtx jump;
+{
+  register rtx label = JUMP_LABEL (jump);
+  register rtx compare, target, jump2, nlabel;
+  register int i, outcomes1, outcomes2;
+
+  if (label == 0)
+    return 0;
+  outcomes1 = cc0_jump_outcomes (jump);
+  if (outcomes1 == 0)
+    return 0;
+  compare = cc0_jump_compare (jump);
+  if (compare == 0 || thread_side_effects_p (SET_SRC (PATTERN (compare))))
+    return 0;
+
+  /* Find the insn the label leads to.  */
+  i = CODE_LABEL_NUMBER (label) - first_chained_label;
+  target = 0;
+  if (i >= 0 && i < label_first_insn_size)
+    target = label_first_insn[i];
+  if (target == 0)
+    target = next_real_insn (label);
+
+  /* It must be the same comparison, followed by a conditional jump.  */
+  if (target == 0 || GET_CODE (target) != INSN
+      || GET_CODE (PATTERN (target)) != SET
+      || SET_DEST (PATTERN (target)) != cc0_rtx
+      || ! rtx_equal_p (SET_SRC (PATTERN (target)),
+			SET_SRC (PATTERN (compare))))
+    return 0;
+  jump2 = NEXT_INSN (target);
+  while (jump2 && GET_CODE (jump2) == NOTE)
+    jump2 = NEXT_INSN (jump2);
+  if (jump2 == 0 || GET_CODE (jump2) != JUMP_INSN
+      || JUMP_LABEL (jump2) == 0)
+    return 0;
+  outcomes2 = cc0_jump_outcomes (jump2);
+  if (outcomes2 == 0)
+    return 0;
+
+  /* Is JUMP2 certain to jump, or certain not to, when JUMP jumps?  */
+  if ((outcomes1 & ~outcomes2) == 0)
+    nlabel = JUMP_LABEL (jump2);
+  else if ((outcomes1 & outcomes2) == 0)
+    {
+      nlabel = NEXT_INSN (jump2);
+      if (nlabel == 0 || GET_CODE (nlabel) != CODE_LABEL)
+	{
+	  nlabel = gen_label_rtx ();
+	  emit_label_after (nlabel, jump2);
+	  LABEL_NUSES (nlabel) = 0;
+	}
+    }
+  else
+    return 0;
+
+  if (nlabel == label)
+    return 0;
+
+  /* Keep the old label for now, even if no longer used;
+     jump_optimize deletes it later, along with any code
+     that has become unreachable.  */
+  ++LABEL_NUSES (label);
+  redirect_jump (jump, nlabel);
+  --LABEL_NUSES (label);
+  return 1;
+}
+
+/* If INSN is a conditional jump on the condition codes, return the
+   insn that sets them for it, provided that does nothing else.
+   Otherwise return 0.  */
+
+static rtx
+cc0_jump_compare (insn)
+     rtx insn;
+{
+  register rtx prev = PREV_INSN (insn);
+
+  while (prev && GET_CODE (prev) == NOTE)
+    prev = PREV_INSN (prev);
+  if (prev && GET_CODE (prev) == INSN
+      && GET_CODE (PATTERN (prev)) == SET
+      && SET_DEST (PATTERN (prev)) == cc0_rtx)
+    return prev;
+  return 0;
+}
+
+/* The outcomes of a comparison, as bits.
+   Each combination of signed and unsigned order is a separate outcome.  */
+
+#define OUTCOME_EQ 1
+#define OUTCOME_LT_LTU 2
+#define OUTCOME_LT_GTU 4
+#define OUTCOME_GT_LTU 8
+#define OUTCOME_GT_GTU 16
+#define ALL_OUTCOMES 31
+
+/* If INSN is a conditional jump that tests the condition codes
+   against zero, return the set of comparison outcomes for which it
+   jumps.  Otherwise return 0.  */
+
+static int
+cc0_jump_outcomes (insn)
+     rtx insn;
+{
+  register rtx x = PATTERN (insn);
+  register rtx cond;
+  register int outcomes;
+
+  if (GET_CODE (x) != SET || SET_DEST (x) != pc_rtx
+      || GET_CODE (SET_SRC (x)) != IF_THEN_ELSE)
+    return 0;
+
+  cond = XEXP (SET_SRC (x), 0);
+  if (XEXP (cond, 0) != cc0_rtx || XEXP (cond, 1) != const0_rtx)
+    return 0;
+
+  switch (GET_CODE (cond))
+    {
+    case EQ:
+      outcomes = OUTCOME_EQ;
+      break;
+    case NE:
+      outcomes = ALL_OUTCOMES & ~OUTCOME_EQ;
+      break;
+    case LT:
+      outcomes = OUTCOME_LT_LTU | OUTCOME_LT_GTU;
+      break;
+    case LE:
+      outcomes = OUTCOME_LT_LTU | OUTCOME_LT_GTU | OUTCOME_EQ;
+      break;
+    case GT:
+      outcomes = OUTCOME_GT_LTU | OUTCOME_GT_GTU;
+      break;
+    case GE:
+      outcomes = OUTCOME_GT_LTU | OUTCOME_GT_GTU | OUTCOME_EQ;
+      break;
+    case LTU:
+      outcomes = OUTCOME_LT_LTU | OUTCOME_GT_LTU;
+      break;
+    case LEU:
+      outcomes = OUTCOME_LT_LTU | OUTCOME_GT_LTU | OUTCOME_EQ;
+      break;
+    case GTU:
+      outcomes = OUTCOME_LT_GTU | OUTCOME_GT_GTU;
+      break;
+    case GEU:
+      outcomes = OUTCOME_LT_GTU | OUTCOME_GT_GTU | OUTCOME_EQ;
+      break;
+    default:
+      return 0;
+    }
+
+  if (GET_CODE (XEXP (SET_SRC (x), 1)) == LABEL_REF
+      && XEXP (SET_SRC (x), 2) == pc_rtx)
+    return outcomes;
+  if (XEXP (SET_SRC (x), 1) == pc_rtx
+      && GET_CODE (XEXP (SET_SRC (x), 2)) == LABEL_REF)
+    return ALL_OUTCOMES & ~outcomes;
+  return 0;
+}
+
+/* Return nonzero if evaluating X twice might not give the same value
+   both times: if it increments a reg, calls a function
+   or refers to something volatile.  */
+
+static int
+thread_side_effects_p (x)
+     rtx x;
+{
+  register RTX_CODE code = GET_CODE (x);
+  register int i, j;
+  register char *fmt;
+
+  if (code == PRE_INC || code == PRE_DEC || code == POST_INC
+      || code == POST_DEC || code == CALL || code == VOLATILE)
+    return 1;
+
+  fmt = GET_RTX_FORMAT (code);
+  for (i = GET_RTX_LENGTH (code) - 1; i >= 0; i--)
+    {
+      if (fmt[i] == 'e')
+	{
+	  if (thread_side_effects_p (XEXP (x, i)))
+	    return 1;
+	}
+      else if (fmt[i] == 'E')
+	for (j = 0; j < XVECLEN (x, i); j++)
+	  if (thread_side_effects_p (XVECEXP (x, i, j)))
+	    return 1;
+    }
+  return 0;
+}
+
+/* Print the jump threading statistics for the current function on FILE.  */
+
+void
+dump_jump_stats (file)
+     FILE *file;
+{
+  fprintf (file, ";; Jump threading: %d conditional jumps threaded.\n\n",
+	   jump_threads);
+}
+
+/* Print the jump threading statistics for the whole file on FILE.  */
+
+void
+dump_jump_total_stats (file)
+     FILE *file;
+{
+  fprintf (file, "\n;; Jump threading totals: %d conditional jumps threaded.\n",
+	   total_jump_threads);
+}
+
 /* Return 1 if INSN is an unconditional jump and nothing else.  */
 
 static int
@@ -450,15 +1404,16 @@ follow_jumps (label)
   return value;
 }
 
-/* Assuming that field IDX of X is a vector of label_refs,
+/* Assuming that field IDX of the pattern of INSN is a vector of label_refs,
    replace each of them by the ultimate label reached by it.
    Return nonzero if a change is made.  */
 
 static int
-tension_vector_labels (x, idx)
-     register rtx x;
+tension_vector_labels (insn, idx)
+     rtx insn;
      register int idx;
 {
+  register rtx x = PATTERN (insn);
   int changed = 0;
   register int i;
   for (i = XVECLEN (x, idx) - 1; i >= 0; i--)
@@ -467,7 +1422,9 @@ tension_vector_labels (x, idx)
       register rtx nlabel = follow_jumps (olabel);
       if (nlabel != olabel)
 	{
+	  chain_jump_labels (XVECEXP (x, idx, i), insn, 0);
 	  XEXP (XVECEXP (x, idx, i), 0) = nlabel;
+	  chain_jump_labels (XVECEXP (x, idx, i), insn, 1);
 	  ++LABEL_NUSES (nlabel);
 	  if (--LABEL_NUSES (olabel) == 0)
 	    delete_insn (olabel);
@@ -478,7 +1435,7 @@ tension_vector_labels (x, idx)
 }
 
 /* Find all CODE_LABELs referred to in X,
-   and increment their use counts.
+   and increment their use counts and put INSN on their jump chains.
    Also store one of them in JUMP_LABEL (INSN).  */
 
 static void
@@ -496,6 +1453,7 @@ mark_jump_label (x, insn)
       if (GET_CODE (label) != CODE_LABEL)
 	return;
       ++LABEL_NUSES (label);
+      chain_jump_labels (x, insn, 1);
       JUMP_LABEL (insn) = label;
       return;
     }
@@ -555,6 +1513,18 @@ delete_insn (insn)
   register rtx next = NEXT_INSN (insn);
   register rtx prev = PREV_INSN (insn);
 
+  /* Take a deleted jump off the chains of the labels it refers to;
+     a deleted label is reached by no jumps.  */
+
+  if (GET_CODE (insn) == JUMP_INSN)
+    chain_jump_labels (PATTERN (insn), insn, 0);
+  else if (GET_CODE (insn) == CODE_LABEL)
+    {
+      register rtx *slot = label_jump_chain_slot (insn, 0);
+      if (slot)
+	*slot = 0;
+    }
+
   /* If instruction is followed by a barrier,
      delete the barrier too.  */
 
@@ -611,7 +1581,9 @@ invert_jump (jump, nlabel)
      rtx jump, nlabel;
 {
   register rtx olabel = JUMP_LABEL (jump);
+  chain_jump_labels (PATTERN (jump), jump, 0);
   invert_exp (PATTERN (jump), olabel, nlabel);
+  chain_jump_labels (PATTERN (jump), jump, 1);
   JUMP_LABEL (jump) = nlabel;
   ++LABEL_NUSES (nlabel);
   INSN_CODE (jump) = -1;
@@ -675,7 +1647,9 @@ redirect_jump (jump, nlabel)
   if (nlabel == olabel)
     return;
 
+  chain_jump_labels (PATTERN (jump), jump, 0);
   redirect_exp (PATTERN (jump), olabel, nlabel);
+  chain_jump_labels (PATTERN (jump), jump, 1);
   JUMP_LABEL (jump) = nlabel;
   ++LABEL_NUSES (nlabel);
   INSN_CODE (jump) = -1;
@@ -716,3 +1690,130 @@ redirect_exp (x, olabel, nlabel)
 	}
     }
 }
+
+/* Make the label jump chains empty, ready to describe the insns
+   starting with F.  */
+
+static void
+init_label_jump_chains (f)
+     rtx f;
+{
+  register rtx insn;
+  register int first = label_no;
+  register int size;
+
+  for (insn = f; insn; insn = NEXT_INSN (insn))
+    if (GET_CODE (insn) == CODE_LABEL && CODE_LABEL_NUMBER (insn) < first)
+      first = CODE_LABEL_NUMBER (insn);
+
+  /* Leave room for some labels made by later passes.  */
+  size = label_no - first + 32;
+  if (size > label_jump_chain_size)
+    {
+      if (label_jump_chain)
+	free (label_jump_chain);
+      label_jump_chain = (rtx *) xmalloc (size * sizeof (rtx));
+      label_jump_chain_size = size;
+    }
+
+  first_chained_label = first;
+  bzero (label_jump_chain, label_jump_chain_size * sizeof (rtx));
+}
+
+/* Return the address of the jump chain of LABEL.
+   If LABEL is beyond the end of the table, make the table bigger
+   if GROW is nonzero; otherwise return 0.
+   Also return 0 for a label of a function already compiled.  */
+
+static rtx *
+label_jump_chain_slot (label, grow)
+     rtx label;
+     int grow;
+{
+  register int i = CODE_LABEL_NUMBER (label) - first_chained_label;
+
+  if (i < 0)
+    return 0;
+
+  if (i >= label_jump_chain_size)
+    {
+      register int size = i + 1 + label_jump_chain_size / 2;
+      if (! grow)
+	return 0;
+      if (label_jump_chain)
+	label_jump_chain
+	  = (rtx *) xrealloc (label_jump_chain, size * sizeof (rtx));
+      else
+	label_jump_chain = (rtx *) xmalloc (size * sizeof (rtx));
+      bzero (label_jump_chain + label_jump_chain_size,
+	     (size - label_jump_chain_size) * sizeof (rtx));
+      label_jump_chain_size = size;
+    }
+
+  return &label_jump_chain[i];
+}
+
+/* For each LABEL_REF to a CODE_LABEL within X,
+   put jump insn INSN on the label's jump chain if ADD is nonzero,
+   or take one occurrence of INSN off that chain if ADD is zero.  */
+
+static void
+chain_jump_labels (x, insn, add)
+     rtx x, insn;
+     int add;
+{
+  register RTX_CODE code = GET_CODE (x);
+  register int i;
+  register char *fmt;
+
+  if (code == LABEL_REF)
+    {
+      register rtx label = XEXP (x, 0);
+      register rtx *slot;
+
+      if (GET_CODE (label) != CODE_LABEL)
+	return;
+      slot = label_jump_chain_slot (label, add);
+      if (slot == 0)
+	return;
+
+      if (add)
+	*slot = gen_rtx (INSN_LIST, VOIDmode, insn, *slot);
+      else
+	for (; *slot; slot = &XEXP (*slot, 1))
+	  if (XEXP (*slot, 0) == insn)
+	    {
+	      *slot = XEXP (*slot, 1);
+	      break;
+	    }
+      return;
+    }
+
+  fmt = GET_RTX_FORMAT (code);
+  for (i = GET_RTX_LENGTH (code) - 1; i >= 0; i--)
+    {
+      if (fmt[i] == 'e')
+	chain_jump_labels (XEXP (x, i), insn, add);
+      else if (fmt[i] == 'E')
+	{
+	  register int j;
+	  for (j = 0; j < XVECLEN (x, i); j++)
+	    chain_jump_labels (XVECEXP (x, i, j), insn, add);
+	}
+    }
+}
+
+/* Return an INSN_LIST chain of the jump insns that refer to LABEL.
+   This is valid after jump_optimize, provided that since then
+   the labels of jumps have been changed only with delete_insn,
+   redirect_jump and invert_jump.  An element whose insn is no longer
+   a JUMP_INSN should be ignored.  */
+
+rtx
+jumps_to_label (label)
+     rtx label;
+{
+  register rtx *slot = label_jump_chain_slot (label, 0);
+
+  return slot ? *slot : 0;
+}
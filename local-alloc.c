@@ -264,7 +264,7 @@ block_alloc (b)
   register rtx insn;
   int insn_number = 0;
   int insn_count = 0;
-  short *qty_order;
+  int *qty_order;
 
   call_seen = 0;
 
@@ -446,7 +446,7 @@ block_alloc (b)
 
   /* Now order the qtys so we assign them registers
      in order of decreasing length of life.  */
-  qty_order = (short *) alloca (next_qty * sizeof (short));
+  qty_order = (int *) alloca (next_qty * sizeof (int));
   for (i = FIRST_PSEUDO_REGISTER; i < next_qty; i++)
     qty_order[i] = i;
 
@@ -469,7 +469,7 @@ block_alloc (b)
     }
   else if (next_qty > 3 + FIRST_PSEUDO_REGISTER)
     qsort (qty_order + FIRST_PSEUDO_REGISTER,
-	   next_qty - FIRST_PSEUDO_REGISTER, sizeof (short), qty_better_p_1);
+	   next_qty - FIRST_PSEUDO_REGISTER, sizeof (int), qty_better_p_1);
 
   /* Now for each qty that is not a hardware register,
      look for a hardware register to put it in.
@@ -523,7 +523,7 @@ qty_better_p (q1, q2)
 
 static int
 qty_better_p_1 (q1, q2)
-     short *q1, *q2;
+     int *q1, *q2;
 {
   return ((qty_death[*q1] - qty_birth[*q1]) * qty_size[*q2]
 	  > (qty_death[*q2] - qty_birth[*q2]) * qty_size[*q1]);
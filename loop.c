@@ -28,13 +28,15 @@ and this notice must be preserved on all copies.  */
    and changes these to zero the entire register once before the loop
    and merely copy the low part within the loop.
 
+   If -funroll-loops was specified, it then unrolls innermost loops
+   whose trip count is a compile-time constant.
+
    Most of the complexity is in heuristics to decide when it is worth
    while to do these things.  */
 
-/* ??? verify_loop would run faster if we made one table
-   of the minimum and maximum luids from which each label is reached.
-   Also, it would be faster if loop_store_addrs were a hash table.  */
+/* ??? verify_loop would be faster if loop_store_addrs were a hash table.  */
 
+#include <stdio.h>
 #include "config.h"
 #include "rtl.h"
 #include "insn-config.h"
@@ -45,7 +47,7 @@ and this notice must be preserved on all copies.  */
    The luids are like uids but increase monononically always.
    We use them to see whether a jump comes from outside a given loop.  */
 
-static short *uid_luid;
+static int *uid_luid;
 
 /* Get the luid of an insn.  */
 
@@ -104,6 +106,28 @@ static int loop_store_widths[NUM_STORES];
 /* Index of first available slot in above array.  */
 static int loop_store_addrs_idx;
 
+/* Statistics on unrolling for the current function, and totals.
+   `unroll_tests_before' and `unroll_tests_after' count the loop tests
+   (each a compare insn and a conditional jump) that the unrolled loops
+   execute at run time before and after unrolling.  */
+
+static int loops_unrolled;
+static int loops_unrolled_completely;
+static int unroll_insns_copied;
+static int unroll_tests_before;
+static int unroll_tests_after;
+
+static int total_unrolled, total_unrolled_completely, total_unroll_copied;
+static int total_tests_before, total_tests_after;
+
+/* Record of the live range splits made in the current function:
+   for each, the old reg, the new reg, and the uid of the loop's
+   NOTE_INSN_LOOP_BEG.  */
+
+static int *split_regs;
+static int split_regs_size;
+static int n_split_regs;
+
 /* During the analysis of a loop, a chain of `struct movable's
    is made to record all the movable insns found.
    Then the entire chain can be scanned to decide which to move.  */
@@ -112,7 +136,7 @@ struct movable
 {
   rtx insn;			/* A movable insn */
   int regno;			/* The register it sets */
-  short lifetime;		/* lifetime of that register;
+  int lifetime;			/* lifetime of that register;
 				   may be adjusted when matching movables
 				   that load the same value are found.  */
   unsigned int cond : 1;	/* 1 if only conditionally movable */
@@ -126,13 +150,29 @@ struct movable
 
 static rtx verify_loop ();
 static int invariant_p ();
-static int can_jump_into_range_p ();
 static void count_loop_regs_set ();
 static void note_addr_stored ();
 static int loop_reg_used_before_p ();
 static void constant_high_bytes ();
 static void scan_loop ();
 static rtx replace_regs ();
+static void unroll_loops_in ();
+static void unroll_loop ();
+static void count_reg_refs ();
+static void note_iv_stored ();
+static void split_live_ranges_in ();
+
+extern int xmalloc ();
+extern int xrealloc ();
+
+/* Nonzero means unroll loops whose trip count is known.  -funroll-loops.  */
+
+extern int unroll_loops;
+
+/* Nonzero means split the lives of long-lived pseudo regs at loops.
+   -fsplit-live-ranges.  */
+
+extern int split_live_ranges;
 
 /* Entry point of this file.  Perform loop optimization
    on the current function.  F is the first insn of the function
@@ -152,6 +192,13 @@ loop_optimize (f, nregs)
 
   init_recog ();
 
+  loops_unrolled = 0;
+  loops_unrolled_completely = 0;
+  unroll_insns_copied = 0;
+  unroll_tests_before = 0;
+  unroll_tests_after = 0;
+  n_split_regs = 0;
+
   /* First find the last real insn, and count the number of insns,
      and assign insns their suids.  */
 
@@ -160,8 +207,8 @@ loop_optimize (f, nregs)
       i = INSN_UID (insn);
 
   max_uid = i + 1;
-  uid_luid = (short *) alloca ((i + 1) * sizeof (short));
-  bzero (uid_luid, (i + 1) * sizeof (short));
+  uid_luid = (int *) alloca ((i + 1) * sizeof (int));
+  bzero (uid_luid, (i + 1) * sizeof (int));
 
   /* Compute the mapping from uids to luids.
      LUIDs are numbers assigned to insns, like uids,
@@ -194,6 +241,22 @@ loop_optimize (f, nregs)
 	/* Make sure it really is a loop -- no jumps in from outside.  */
 	&& (end = verify_loop (f, insn)))
       scan_loop (insn, end, nregs);
+
+  /* Now that the invariants are out, unroll what we can.  */
+
+  if (unroll_loops)
+    unroll_loops_in (f, max_reg_num ());
+
+  /* Then give long-lived regs separate pieces within loops.  */
+
+  if (split_live_ranges)
+    split_live_ranges_in (f, nregs);
+
+  total_unrolled += loops_unrolled;
+  total_unrolled_completely += loops_unrolled_completely;
+  total_unroll_copied += unroll_insns_copied;
+  total_tests_before += unroll_tests_before;
+  total_tests_after += unroll_tests_after;
 }
 
 /* Optimize one loop whose start is LOOP_START and end is END.
@@ -223,11 +286,11 @@ scan_loop (loop_start, end, nregs)
      is set during the loop being scanned, or -1 if the insns that set it
      have all been scanned as candidates for being moved out of the loop.
      0 indicates an invariant register; -1 a conditionally invariant one.  */
-  short *n_times_set;
+  int *n_times_set;
   /* Indexed by register number, contains the number of times the reg
      was set during the loop being scanned, not counting changes due
      to moving these insns out of the loop.  */
-  short *n_times_used;
+  int *n_times_used;
   /* Indexed by register number, contains 1 for a register whose
      assignments may not be moved out of the loop.  */
   char *may_not_move;
@@ -241,8 +304,8 @@ scan_loop (loop_start, end, nregs)
      and more registers are available.  */
   int threshold = loop_has_call ? 15 : 30;
 
-  n_times_set = (short *) alloca (nregs * sizeof (short));
-  n_times_used = (short *) alloca (nregs * sizeof (short));
+  n_times_set = (int *) alloca (nregs * sizeof (int));
+  n_times_used = (int *) alloca (nregs * sizeof (int));
   may_not_move = (char *) alloca (nregs);
 
   /* Determine whether this loop starts with a jump down
@@ -285,13 +348,13 @@ scan_loop (loop_start, end, nregs)
      Set MAY_NOT_MOVE[I] if it is not safe to move out
      the setting of register I.  */
 
-  bzero (n_times_set, nregs * sizeof (short));
+  bzero (n_times_set, nregs * sizeof (int));
   bzero (may_not_move, nregs);
   count_loop_regs_set (loop_start, end, n_times_set, may_not_move, 
 		       &insn_count, nregs);
   for (i = 0; i < FIRST_PSEUDO_REGISTER; i++)
     may_not_move[i] = 1, n_times_set[i] = 1;
-  bcopy (n_times_set, n_times_used, nregs * sizeof (short));
+  bcopy (n_times_set, n_times_used, nregs * sizeof (int));
 
   /* Scan through the loop finding insns that are safe to move.
      In each such insn, store QImode as the mode, to mark it.
@@ -707,80 +770,29 @@ verify_loop (f, start)
 
   end = insn;
 
-  /* Now scan all jumps in the function and see if any of them can
-     reach a label within the range of the loop.  */
-
-  for (insn = f; insn; insn = NEXT_INSN (insn))
-    if (GET_CODE (insn) == JUMP_INSN
-	/* Don't get fooled by jumps inserted by loop-optimize.
-	   They don't have valid LUIDs, and they never jump into loops.  */
-	&& INSN_UID (insn) < max_uid
-	&& (INSN_LUID (insn) < INSN_LUID (start)
-	    || INSN_LUID (insn) > INSN_LUID (end))
-	/* We have a jump that is outside the loop.
-	   Does it jump into the loop?  */
-	&& can_jump_into_range_p (PATTERN (insn),
-				  INSN_LUID (start), INSN_LUID (end)))
-      return 0;
-
-#if 0      
   /* Now scan all labels between them and check for any jumps from outside.
-     This uses the ref-chains set up by find_basic_blocks.
-     This code is not used because it's more convenient for other reasons
-     to do the loop optimization before find_basic_blocks.  */
+     This uses the jump chains that jump_optimize keeps for each label.  */
 
   for (insn = start; insn != end; insn = NEXT_INSN (insn))
     if (GET_CODE (insn) == CODE_LABEL)
       {
 	register rtx y;
-	for (y = LABEL_REFS (insn); y != insn; y = LABEL_NEXTREF (y))
-	  if (INSN_LUID (CONTAINING_INSN (y)) < INSN_LUID (start)
-	      || INSN_LUID (CONTAINING_INSN (y)) > INSN_LUID (end))
-	    return 0;
+	for (y = jumps_to_label (insn); y; y = XEXP (y, 1))
+	  {
+	    register rtx jump = XEXP (y, 0);
+	    if (GET_CODE (jump) == JUMP_INSN
+		/* Don't get fooled by jumps inserted by loop-optimize.
+		   They don't have valid LUIDs, and they never jump into loops.  */
+		&& INSN_UID (jump) < max_uid
+		&& (INSN_LUID (jump) < INSN_LUID (start)
+		    || INSN_LUID (jump) > INSN_LUID (end)))
+	      return 0;
+	  }
       }
-#endif
 
   return end;
 }
 
-/* Return 1 if somewhere in X is a LABEL_REF to a label
-   located between BEG and END.  */
-
-static int
-can_jump_into_range_p (x, beg, end)
-     rtx x;
-     int beg, end;
-{
-  register RTX_CODE code = GET_CODE (x);
-  register int i;
-  register char *fmt;
-
-  if (code == LABEL_REF)
-    {
-      register int luid = INSN_LUID (XEXP (x, 0));
-      return luid > beg && luid < end;
-    }
-
-  fmt = GET_RTX_FORMAT (code);
-  for (i = GET_RTX_LENGTH (code) - 1; i >= 0; i--)
-    {
-      if (fmt[i] == 'e')
-	{
-	  if (can_jump_into_range_p (XEXP (x, i), beg, end))
-	    return 1;
-	}
-      else if (fmt[i] == 'E')
-	{
-	  register int j;
-	  for (j = 0; j < XVECLEN (x, i); j++)
-	    if (can_jump_into_range_p (XVECEXP (x, i, j), beg, end))
-	      return 1;
-	}
-    }
-
-  return 0;
-}
-
 /* Record that a memory reference X is being set.  */
 
 static void
@@ -842,7 +854,7 @@ note_addr_stored (x)
 static int
 invariant_p (x, n_times_set)
      register rtx x;
-     short *n_times_set;
+     int *n_times_set;
 {
   register int i;
   register RTX_CODE code = GET_CODE (x);
@@ -985,7 +997,7 @@ all_sets_invariant_p (reg, insn, table)
 static void
 count_loop_regs_set (from, to, n_times_set, may_not_move, count_ptr, nregs)
      register rtx from, to;
-     short *n_times_set;
+     int *n_times_set;
      char *may_not_move;
      int *count_ptr;
      int nregs;
@@ -1090,3 +1102,935 @@ loop_reg_used_before_p (insn, loop_start, scan_start, loop_end)
   else
     return reg_used_between_p (reg, scan_start, insn);
 }
+
+/* Loop unrolling.
+
+   After the invariant computations have been moved out, an innermost
+   loop whose body is straight-line code and whose trip count is known
+   at compile time can be unrolled: the body is duplicated in place,
+   and the test and branch that would have separated the copies
+   are simply not emitted.
+
+   The loop must have one of the shapes made by `expand_loop' and
+   by `scan_loop' above:
+
+	LOOP_BEG  top: body  test  jcc top  LOOP_END
+	LOOP_BEG  jump cont  barrier  top: body  cont: test  jcc top  LOOP_END
+	LOOP_BEG  test  jcc exit  top: body  test  jcc top  exit: LOOP_END
+
+   and the test must compare one register, incremented by a constant
+   exactly once in the body and set to a constant just before the loop,
+   against a constant.
+
+   If the whole loop fits in MAX_UNROLLED_INSNS, it is unrolled completely
+   and the test disappears.  Otherwise the body is copied a number of times
+   that divides the trip count evenly, so no exit test is needed between
+   the copies.  Pseudo registers used only within one iteration of the
+   body are renamed in each copy so that the copies do not compete
+   for the same hard registers.  */
+
+/* Limit on the number of insns in the body after unrolling.  */
+
+#ifndef MAX_UNROLLED_INSNS
+#define MAX_UNROLLED_INSNS 100
+#endif
+
+/* Limit on the number of copies of the body in a loop
+   that is not unrolled completely.  */
+
+#ifndef MAX_UNROLL_FACTOR
+#define MAX_UNROLL_FACTOR 4
+#endif
+
+/* Don't bother computing trip counts larger than this.  */
+
+#ifndef MAX_UNROLL_TRIP_COUNT
+#define MAX_UNROLL_TRIP_COUNT 65536
+#endif
+
+/* Used by `note_iv_stored' to look for stores in the induction register.  */
+
+static rtx unroll_iv;
+static int unroll_iv_stored;
+
+/* Set nonzero by `count_reg_refs' on seeing a register
+   too new to be in its tables.  */
+
+static int unroll_reg_too_new;
+
+/* Unroll suitable innermost loops in the insns starting at F.
+   NREGS is the number of registers used in them.  */
+
+static void
+unroll_loops_in (f, nregs)
+     rtx f;
+     int nregs;
+{
+  register rtx insn;
+  rtx end;
+  /* Indexed by register number, the number of times the register
+     is mentioned anywhere in the function.  */
+  int *reg_refs = (int *) alloca (nregs * sizeof (int));
+
+  bzero (reg_refs, nregs * sizeof (int));
+  unroll_reg_too_new = 0;
+  for (insn = f; insn; insn = NEXT_INSN (insn))
+    if (GET_CODE (insn) == INSN || GET_CODE (insn) == JUMP_INSN
+	|| GET_CODE (insn) == CALL_INSN)
+      count_reg_refs (PATTERN (insn), reg_refs, 0, 0, nregs);
+
+  for (insn = f; insn; insn = NEXT_INSN (insn))
+    if (GET_CODE (insn) == NOTE
+	&& NOTE_LINE_NUMBER (insn) == NOTE_INSN_LOOP_BEG
+	&& (end = verify_loop (f, insn)))
+      unroll_loop (insn, end, nregs, reg_refs);
+}
+
+/* Count the references to each register in X by incrementing COUNTS.
+   If STATUS is nonzero, also record for each register that was
+   not yet seen whether it is first stored (1) or first used (2).
+   SETTING nonzero means X is the destination of a SET.
+   Registers numbered NREGS or higher set `unroll_reg_too_new'.  */
+
+static void
+count_reg_refs (x, counts, status, setting, nregs)
+     rtx x;
+     int *counts;
+     char *status;
+     int setting;
+     int nregs;
+{
+  register RTX_CODE code = GET_CODE (x);
+  register int i;
+  register char *fmt;
+
+  switch (code)
+    {
+    case PC:
+    case CC0:
+    case CONST_INT:
+    case CONST_DOUBLE:
+    case SYMBOL_REF:
+    case LABEL_REF:
+      return;
+
+    case REG:
+      if (REGNO (x) >= nregs)
+	{
+	  unroll_reg_too_new = 1;
+	  return;
+	}
+      counts[REGNO (x)]++;
+      if (status != 0 && status[REGNO (x)] == 0)
+	status[REGNO (x)] = setting ? 1 : 2;
+      return;
+
+    case SET:
+      /* Scan the value before the destination, since it is used first.
+	 Only a whole register is really set; a store into part of one
+	 counts as a use of the rest.  */
+      count_reg_refs (SET_SRC (x), counts, status, 0, nregs);
+      count_reg_refs (SET_DEST (x), counts, status,
+		      GET_CODE (SET_DEST (x)) == REG, nregs);
+      return;
+    }
+
+  fmt = GET_RTX_FORMAT (code);
+  for (i = GET_RTX_LENGTH (code) - 1; i >= 0; i--)
+    {
+      if (fmt[i] == 'e')
+	count_reg_refs (XEXP (x, i), counts, status, 0, nregs);
+      if (fmt[i] == 'E')
+	{
+	  register int j;
+	  for (j = 0; j < XVECLEN (x, i); j++)
+	    count_reg_refs (XVECEXP (x, i, j), counts, status, 0, nregs);
+	}
+    }
+}
+
+/* Called via note_stores: record whether X is `unroll_iv'.  */
+
+static void
+note_iv_stored (x)
+     rtx x;
+{
+  if (GET_CODE (x) == REG && REGNO (x) == REGNO (unroll_iv))
+    unroll_iv_stored = 1;
+}
+
+/* Return nonzero if the comparison CODE of A and B is true.
+   CODE is one of the codes that can appear in a conditional jump.
+   Return -1 if CODE is not understood.  */
+
+static int
+unroll_compare (code, a, b)
+     RTX_CODE code;
+     int a, b;
+{
+  switch (code)
+    {
+    case EQ:
+      return a == b;
+    case NE:
+      return a != b;
+    case LT:
+      return a < b;
+    case LE:
+      return a <= b;
+    case GT:
+      return a > b;
+    case GE:
+      return a >= b;
+    case LTU:
+      return (unsigned) a < (unsigned) b;
+    case LEU:
+      return (unsigned) a <= (unsigned) b;
+    case GTU:
+      return (unsigned) a > (unsigned) b;
+    case GEU:
+      return (unsigned) a >= (unsigned) b;
+    }
+  return -1;
+}
+
+/* Return the number of times the body of a loop is executed
+   if its induction register starts at INIT and is increased by STEP
+   in each iteration, and the loop continues while OP0 CODE OP1 is true
+   (false, if REVERSE is nonzero) with the current value substituted for IV.
+   TEST_FIRST nonzero means the test is made before the first iteration.
+   Return -1 if the count is unknown or too large to bother with.  */
+
+static int
+unroll_trip_count (code, reverse, op0, op1, iv, init, step, test_first)
+     RTX_CODE code;
+     int reverse;
+     rtx op0, op1, iv;
+     int init, step, test_first;
+{
+  register int n, v = init;
+  int a, b, cond;
+
+  if (test_first)
+    n = 0;
+  else
+    v += step, n = 1;
+
+  for (; n <= MAX_UNROLL_TRIP_COUNT; n++, v += step)
+    {
+      a = op0 == iv ? v : INTVAL (op0);
+      b = op1 == iv ? v : INTVAL (op1);
+      cond = unroll_compare (code, a, b);
+      if (cond < 0)
+	return -1;
+      if (cond == reverse)
+	return n;
+    }
+  return -1;
+}
+
+/* Return the next insn after INSN that is not a NOTE.  */
+
+static rtx
+next_nonnote_insn (insn)
+     rtx insn;
+{
+  do
+    insn = NEXT_INSN (insn);
+  while (insn && GET_CODE (insn) == NOTE);
+  return insn;
+}
+
+/* Turn INSN into a deleted-insn note, without any of the
+   side effects of `delete_insn'.  */
+
+static void
+make_insn_deleted (insn)
+     rtx insn;
+{
+  PUT_CODE (insn, NOTE);
+  NOTE_LINE_NUMBER (insn) = NOTE_INSN_DELETED;
+  NOTE_SOURCE_FILE (insn) = 0;
+}
+
+/* If X is (if_then_else (COND (cc0) (const_int 0)) ...)
+   with one arm a LABEL_REF to LABEL and the other PC,
+   return 1 if the jump is taken when COND is true, 0 if when it is false.
+   Return -1 if X is anything else.  */
+
+static int
+cond_jump_sense (x, label)
+     rtx x, label;
+{
+  rtx cond;
+
+  if (GET_CODE (x) != IF_THEN_ELSE)
+    return -1;
+  cond = XEXP (x, 0);
+  if (XEXP (cond, 0) != cc0_rtx || XEXP (cond, 1) != const0_rtx)
+    return -1;
+  if (GET_CODE (XEXP (x, 1)) == LABEL_REF
+      && XEXP (XEXP (x, 1), 0) == label
+      && GET_CODE (XEXP (x, 2)) == PC)
+    return 1;
+  if (GET_CODE (XEXP (x, 2)) == LABEL_REF
+      && XEXP (XEXP (x, 2), 0) == label
+      && GET_CODE (XEXP (x, 1)) == PC)
+    return 0;
+  return -1;
+}
+
+/* Unroll the loop from LOOP_START to END if it is suitable.
+   NREGS and REG_REFS are as in `unroll_loops_in'.  */
+
+static void
+unroll_loop (loop_start, end, nregs, reg_refs)
+     rtx loop_start, end;
+     int nregs;
+     int *reg_refs;
+{
+  register rtx p;
+  /* The label at the top of the loop body.  */
+  rtx top_label;
+  /* Unconditional jump that enters the loop at its test, or 0.  */
+  rtx entry_jump = 0;
+  /* Copy of the end test placed before the loop by scan_loop,
+     and the conditional jump around the loop that follows it.  */
+  rtx entry_test = 0, entry_branch = 0;
+  /* First insn of the body and the insn following it.  */
+  rtx body_start, body_end, body_last;
+  /* Label just before the end test, or 0.  */
+  rtx test_label = 0;
+  /* The insn that sets cc0 and the jump back to TOP_LABEL.  */
+  rtx test, jump;
+  rtx cmp, op0, op1, iv, incr, src;
+  RTX_CODE code;
+  int reverse, init, step, n_iter, factor, complete;
+  int body_insns = 0;
+  int *body_refs;
+  char *first_ref;
+  rtx *reg_map;
+  register int i, j;
+
+  /* Find the entry and the top of the body.  */
+
+  p = next_nonnote_insn (loop_start);
+  if (p == 0)
+    return;
+  if (GET_CODE (p) == JUMP_INSN)
+    {
+      entry_jump = p;
+      if (GET_CODE (PATTERN (p)) != SET
+	  || SET_DEST (PATTERN (p)) != pc_rtx
+	  || GET_CODE (SET_SRC (PATTERN (p))) != LABEL_REF)
+	return;
+      p = next_nonnote_insn (p);
+      if (p == 0 || GET_CODE (p) != BARRIER)
+	return;
+      p = next_nonnote_insn (p);
+    }
+  else if (GET_CODE (p) == INSN
+	   && GET_CODE (PATTERN (p)) == SET
+	   && SET_DEST (PATTERN (p)) == cc0_rtx)
+    {
+      entry_test = p;
+      entry_branch = next_nonnote_insn (p);
+      if (entry_branch == 0 || GET_CODE (entry_branch) != JUMP_INSN)
+	return;
+      p = next_nonnote_insn (entry_branch);
+    }
+  if (p == 0 || GET_CODE (p) != CODE_LABEL)
+    return;
+  top_label = p;
+
+  /* Scan the body.  It must be straight-line code
+     ending with an insn that sets cc0.  */
+
+  body_start = NEXT_INSN (top_label);
+  for (p = body_start; p != end; p = NEXT_INSN (p))
+    {
+      if (GET_CODE (p) == NOTE)
+	continue;
+      if (GET_CODE (p) == CODE_LABEL && test_label == 0)
+	{
+	  test_label = p;
+	  continue;
+	}
+      if (GET_CODE (p) == INSN
+	  && GET_CODE (PATTERN (p)) == SET
+	  && SET_DEST (PATTERN (p)) == cc0_rtx)
+	break;
+      /* Nothing but the test may follow TEST_LABEL.  */
+      if (test_label != 0)
+	return;
+      if (GET_CODE (p) != INSN && GET_CODE (p) != CALL_INSN)
+	return;
+      body_insns++;
+    }
+  if (p == end || body_insns == 0)
+    return;
+  test = p;
+  body_end = test_label ? test_label : test;
+  body_last = PREV_INSN (body_end);
+
+  /* The test must be followed by the jump back to the top,
+     and then nothing but notes and labels.  */
+
+  jump = next_nonnote_insn (test);
+  if (jump == 0 || GET_CODE (jump) != JUMP_INSN
+      || GET_CODE (PATTERN (jump)) != SET
+      || SET_DEST (PATTERN (jump)) != pc_rtx)
+    return;
+  i = cond_jump_sense (SET_SRC (PATTERN (jump)), top_label);
+  if (i < 0)
+    return;
+  reverse = ! i;
+  code = GET_CODE (XEXP (SET_SRC (PATTERN (jump)), 0));
+  for (p = NEXT_INSN (jump); p != end; p = NEXT_INSN (p))
+    if (GET_CODE (p) != NOTE && GET_CODE (p) != CODE_LABEL)
+      return;
+
+  /* An entry jump must go to the test.  */
+  if (entry_jump != 0
+      && (test_label == 0
+	  || XEXP (SET_SRC (PATTERN (entry_jump)), 0) != test_label))
+    return;
+
+  /* Decode the test into OP0 CODE OP1 where one operand is
+     the induction register and the other a constant.  */
+
+  cmp = SET_SRC (PATTERN (test));
+  if (GET_CODE (cmp) == MINUS)
+    op0 = XEXP (cmp, 0), op1 = XEXP (cmp, 1);
+  else
+    op0 = cmp, op1 = const0_rtx;
+  if (GET_CODE (op0) == REG && GET_CODE (op1) == CONST_INT)
+    iv = op0;
+  else if (GET_CODE (op1) == REG && GET_CODE (op0) == CONST_INT)
+    iv = op1;
+  else
+    return;
+  if (REGNO (iv) < FIRST_PSEUDO_REGISTER || REGNO (iv) >= nregs
+      || GET_MODE (iv) != SImode)
+    return;
+  /* The trip count computation wants IV to be the same rtx
+     as the operand.  */
+  unroll_iv = iv;
+
+  /* The induction register must be set exactly once in the body,
+     by adding a constant to itself.  */
+
+  incr = 0;
+  for (p = body_start; p != body_end; p = NEXT_INSN (p))
+    if (GET_CODE (p) == INSN || GET_CODE (p) == CALL_INSN)
+      {
+	unroll_iv_stored = 0;
+	note_stores (PATTERN (p), note_iv_stored);
+	if (unroll_iv_stored)
+	  {
+	    if (incr != 0)
+	      return;
+	    incr = p;
+	  }
+      }
+  if (incr == 0 || GET_CODE (PATTERN (incr)) != SET
+      || GET_CODE (SET_DEST (PATTERN (incr))) != REG)
+    return;
+  src = SET_SRC (PATTERN (incr));
+  if (GET_CODE (src) == PLUS
+      && GET_CODE (XEXP (src, 0)) == REG && REGNO (XEXP (src, 0)) == REGNO (iv)
+      && GET_CODE (XEXP (src, 1)) == CONST_INT)
+    step = INTVAL (XEXP (src, 1));
+  else if (GET_CODE (src) == PLUS
+	   && GET_CODE (XEXP (src, 1)) == REG
+	   && REGNO (XEXP (src, 1)) == REGNO (iv)
+	   && GET_CODE (XEXP (src, 0)) == CONST_INT)
+    step = INTVAL (XEXP (src, 0));
+  else if (GET_CODE (src) == MINUS
+	   && GET_CODE (XEXP (src, 0)) == REG
+	   && REGNO (XEXP (src, 0)) == REGNO (iv)
+	   && GET_CODE (XEXP (src, 1)) == CONST_INT)
+    step = - INTVAL (XEXP (src, 1));
+  else
+    return;
+
+  /* Find the initial value: the last store in the induction register
+     before the loop must set it to a constant, and must be in the same
+     basic block as the loop start.  */
+
+  for (p = PREV_INSN (loop_start); p; p = PREV_INSN (p))
+    {
+      if (GET_CODE (p) == NOTE)
+	continue;
+      if (GET_CODE (p) != INSN && GET_CODE (p) != CALL_INSN)
+	return;
+      unroll_iv_stored = 0;
+      note_stores (PATTERN (p), note_iv_stored);
+      if (unroll_iv_stored)
+	break;
+    }
+  if (p == 0 || GET_CODE (p) != INSN
+      || GET_CODE (PATTERN (p)) != SET
+      || GET_CODE (SET_DEST (PATTERN (p))) != REG
+      || GET_CODE (SET_SRC (PATTERN (p))) != CONST_INT)
+    return;
+  init = INTVAL (SET_SRC (PATTERN (p)));
+
+  /* A loop entered by jumping to the test makes the test
+     before each iteration.  Otherwise the body runs at least once
+     (the test copied by scan_loop only decides whether to enter).  */
+
+  n_iter = unroll_trip_count (code, reverse, op0, op1, iv, init, step,
+			      entry_jump != 0);
+  if (n_iter < 2)
+    return;
+
+  /* Decide how much to unroll.  Complete unrolling of a loop
+     entered through a copy of its test requires knowing that copy
+     does not branch around the loop.  */
+
+  complete = n_iter * body_insns <= MAX_UNROLLED_INSNS;
+  if (complete && entry_test != 0
+      && ! (GET_CODE (PATTERN (entry_branch)) == SET
+	    && SET_DEST (PATTERN (entry_branch)) == pc_rtx
+	    && GET_CODE (SET_SRC (PATTERN (entry_branch))) == IF_THEN_ELSE
+	    && rtx_equal_p (PATTERN (entry_test), PATTERN (test))
+	    && (GET_CODE (XEXP (SET_SRC (PATTERN (entry_branch)), 0))
+		== code)
+	    && (GET_CODE (XEXP (SET_SRC (PATTERN (entry_branch)), reverse ? 1 : 2))
+		== LABEL_REF)
+	    && unroll_trip_count (code, reverse, op0, op1, iv, init, step, 1) > 0))
+    complete = 0;
+
+  if (complete)
+    factor = n_iter;
+  else
+    {
+      for (factor = MAX_UNROLL_FACTOR; factor > 1; factor--)
+	if (n_iter % factor == 0 && factor * body_insns <= MAX_UNROLLED_INSNS)
+	  break;
+      if (factor < 2)
+	return;
+    }
+
+  /* Find the pseudo registers local to one iteration of the body:
+     those mentioned nowhere else (not even in the test),
+     whose first mention in the body stores the whole register.  */
+
+  body_refs = (int *) alloca (nregs * sizeof (int));
+  first_ref = (char *) alloca (nregs);
+  bzero (body_refs, nregs * sizeof (int));
+  bzero (first_ref, nregs);
+  unroll_reg_too_new = 0;
+  for (p = body_start; p != body_end; p = NEXT_INSN (p))
+    if (GET_CODE (p) == INSN || GET_CODE (p) == CALL_INSN)
+      count_reg_refs (PATTERN (p), body_refs, first_ref, 0, nregs);
+  if (unroll_reg_too_new)
+    return;
+
+  /* Now make the copies, each inserted just before the test
+     (or the label before it).  */
+
+  reg_map = (rtx *) alloca (nregs * sizeof (rtx));
+  for (i = 1; i < factor; i++)
+    {
+      bzero (reg_map, nregs * sizeof (rtx));
+      for (j = FIRST_PSEUDO_REGISTER; j < nregs; j++)
+	if (j != REGNO (iv) && first_ref[j] == 1
+	    && body_refs[j] == reg_refs[j])
+	  {
+	    reg_map[j] = gen_reg_rtx (GET_MODE (regno_reg_rtx[j]));
+	    if (REGNO_POINTER_FLAG (j))
+	      mark_reg_pointer (reg_map[j]);
+	  }
+
+      for (p = body_start; ; p = NEXT_INSN (p))
+	{
+	  if (GET_CODE (p) == INSN || GET_CODE (p) == CALL_INSN)
+	    {
+	      register rtx copy, link;
+
+	      copy = emit_insn_before (replace_regs (copy_rtx (PATTERN (p)),
+						     reg_map),
+				       body_end);
+	      if (GET_CODE (p) == CALL_INSN)
+		PUT_CODE (copy, CALL_INSN);
+	      for (link = REG_NOTES (p); link; link = XEXP (link, 1))
+		if ((enum reg_note) GET_MODE (link) == REG_CONST)
+		  REG_NOTES (copy)
+		    = gen_rtx (EXPR_LIST, REG_CONST,
+			       replace_regs (copy_rtx (XEXP (link, 0)), reg_map),
+			       REG_NOTES (copy));
+	      unroll_insns_copied++;
+	    }
+	  if (p == body_last)
+	    break;
+	}
+    }
+
+  /* A loop entered at its test, or through a copy of it,
+     makes one test more than it has iterations.  */
+  i = entry_jump != 0 || entry_test != 0;
+  loops_unrolled++;
+  unroll_tests_before += n_iter + i;
+  if (! complete)
+    {
+      unroll_tests_after += n_iter / factor + i;
+      return;
+    }
+
+  /* The loop is gone; take away the tests and jumps
+     and the notes that say it is a loop.  */
+
+  loops_unrolled_completely++;
+  if (entry_jump != 0)
+    delete_insn (entry_jump);
+  if (entry_test != 0)
+    {
+      delete_insn (entry_branch);
+      make_insn_deleted (entry_test);
+    }
+  make_insn_deleted (test);
+  make_insn_deleted (jump);
+  LABEL_NUSES (top_label)--;
+  NOTE_LINE_NUMBER (loop_start) = NOTE_INSN_DELETED;
+  NOTE_LINE_NUMBER (end) = NOTE_INSN_DELETED;
+}
+
+/* Print the unrolling statistics for the current function on FILE.  */
+
+void
+dump_loop_stats (file)
+     FILE *file;
+{
+  fprintf
+    (file,
+     ";; Loop unrolling: %d loops unrolled (%d completely), %d insns copied,\n;; %d loop tests executed before unrolling, %d after.\n\n",
+     loops_unrolled, loops_unrolled_completely, unroll_insns_copied,
+     unroll_tests_before, unroll_tests_after);
+}
+
+/* Print the unrolling statistics for the whole file on FILE.  */
+
+void
+dump_loop_total_stats (file)
+     FILE *file;
+{
+  fprintf
+    (file,
+     "\n;; Loop unrolling totals: %d loops unrolled (%d completely), %d insns copied,\n;; %d loop tests executed before unrolling, %d after.\n",
+     total_unrolled, total_unrolled_completely, total_unroll_copied,
+     total_tests_before, total_tests_after);
+}
+
+/* Live range splitting.
+
+   A pseudo reg that lives a long way before and after a loop,
+   and is used within it, is given a fresh pseudo reg for the loop:
+   the old reg is copied into the new one just before the loop, the
+   new one is used throughout the loop, and it is copied back just
+   after.  The old reg is then dead within the loop.  So the two
+   pieces are allocated separately, and if there are not enough hard
+   regs for the whole life of the old reg, the piece within the loop,
+   where it is used most, can still get one.
+
+   This is done at the end of loop optimization rather than just
+   before global-alloc, so that life analysis and local-alloc see the
+   pieces as ordinary pseudo regs.  The decisions and their outcome
+   are shown in the global-alloc dump.  */
+
+/* A reg is split at a loop only if its lifetime, in luids,
+   is at least this many times the length of the loop.  */
+
+#ifndef SPLIT_SPAN_RATIO
+#define SPLIT_SPAN_RATIO 4
+#endif
+
+/* ...and if it is mentioned at least this many times within the loop.  */
+
+#ifndef SPLIT_MIN_LOOP_REFS
+#define SPLIT_MIN_LOOP_REFS 2
+#endif
+
+/* Indexed by label number minus `split_first_label',
+   nonzero for the labels within the loop being considered.  */
+
+static char *split_label_inside;
+static int split_first_label, split_last_label;
+
+static int split_labels_ok_p ();
+static void split_loop_regs ();
+static int split_reg_mentioned_p ();
+
+/* Split the lives of suitable pseudo regs at each innermost loop
+   in the insns starting at F.  NREGS is the number of regs that
+   `regno_first_uid' and `regno_last_uid' describe.  */
+
+static void
+split_live_ranges_in (f, nregs)
+     rtx f;
+     int nregs;
+{
+  register rtx insn;
+  int first_label = -1, last_label = -1;
+  rtx end;
+
+  for (insn = f; insn; insn = NEXT_INSN (insn))
+    if (GET_CODE (insn) == CODE_LABEL)
+      {
+	if (first_label < 0 || CODE_LABEL_NUMBER (insn) < first_label)
+	  first_label = CODE_LABEL_NUMBER (insn);
+	if (CODE_LABEL_NUMBER (insn) > last_label)
+	  last_label = CODE_LABEL_NUMBER (insn);
+      }
+
+  split_first_label = first_label;
+  split_last_label = last_label;
+  split_label_inside = (char *) alloca (last_label - first_label + 1);
+  bzero (split_label_inside, last_label - first_label + 1);
+
+  for (insn = f; insn; insn = NEXT_INSN (insn))
+    if (GET_CODE (insn) == NOTE
+	&& NOTE_LINE_NUMBER (insn) == NOTE_INSN_LOOP_BEG
+	&& INSN_UID (insn) < max_uid
+	&& (end = verify_loop (f, insn)))
+      {
+	register rtx p;
+
+	/* Consider only innermost loops.  */
+	for (p = NEXT_INSN (insn); p != end; p = NEXT_INSN (p))
+	  if (GET_CODE (p) == NOTE
+	      && NOTE_LINE_NUMBER (p) == NOTE_INSN_LOOP_BEG)
+	    break;
+	if (p == end && INSN_UID (end) < max_uid)
+	  split_loop_regs (insn, end, nregs);
+      }
+}
+
+/* Return nonzero if every label that X refers to is either within
+   the loop (as marked in `split_label_inside') or is EXIT_LABEL.  */
+
+static int
+split_labels_ok_p (x, exit_label)
+     rtx x, exit_label;
+{
+  register RTX_CODE code = GET_CODE (x);
+  register int i;
+  register char *fmt;
+
+  if (code == LABEL_REF)
+    {
+      register int n = CODE_LABEL_NUMBER (XEXP (x, 0));
+      return (XEXP (x, 0) == exit_label
+	      || (n >= split_first_label && n <= split_last_label
+		  && split_label_inside[n - split_first_label]));
+    }
+
+  fmt = GET_RTX_FORMAT (code);
+  for (i = GET_RTX_LENGTH (code) - 1; i >= 0; i--)
+    {
+      if (fmt[i] == 'e')
+	{
+	  if (! split_labels_ok_p (XEXP (x, i), exit_label))
+	    return 0;
+	}
+      else if (fmt[i] == 'E')
+	{
+	  register int j;
+	  for (j = 0; j < XVECLEN (x, i); j++)
+	    if (! split_labels_ok_p (XVECEXP (x, i, j), exit_label))
+	      return 0;
+	}
+    }
+  return 1;
+}
+
+/* Split the regs that live long before and after the loop
+   from LOOP_START to END, and are used within it.
+   NREGS is as for `split_live_ranges_in'.  */
+
+static void
+split_loop_regs (loop_start, end, nregs)
+     rtx loop_start, end;
+     int nregs;
+{
+  register rtx p;
+  register int i;
+  int max_reg = max_reg_num ();
+  int *refs;
+  rtx *reg_map;
+  rtx exit_label, after;
+  int start_luid = INSN_LUID (loop_start);
+  int end_luid = INSN_LUID (end);
+  int nsplit = 0;
+
+  /* The copy back must be done on every way out of the loop.
+     So the loop must be left only by falling out the end
+     or by jumping to a label right after it, and that label
+     must not be reached from anywhere else.  */
+
+  exit_label = next_nonnote_insn (end);
+  if (exit_label == 0 || GET_CODE (exit_label) != CODE_LABEL)
+    exit_label = 0;
+  else
+    for (p = jumps_to_label (exit_label); p; p = XEXP (p, 1))
+      if (GET_CODE (XEXP (p, 0)) == JUMP_INSN
+	  && (INSN_UID (XEXP (p, 0)) >= max_uid
+	      || INSN_LUID (XEXP (p, 0)) < start_luid
+	      || INSN_LUID (XEXP (p, 0)) > end_luid))
+	return;
+
+  for (p = loop_start; p != end; p = NEXT_INSN (p))
+    if (GET_CODE (p) == CODE_LABEL)
+      split_label_inside[CODE_LABEL_NUMBER (p) - split_first_label] = 1;
+
+  refs = (int *) alloca (max_reg * sizeof (int));
+  bzero (refs, max_reg * sizeof (int));
+
+  for (p = loop_start; p != end; p = NEXT_INSN (p))
+    if (GET_CODE (p) == JUMP_INSN
+	&& (JUMP_LABEL (p) == 0
+	    || GET_CODE (PATTERN (p)) == ADDR_VEC
+	    || GET_CODE (PATTERN (p)) == ADDR_DIFF_VEC
+	    || ! split_labels_ok_p (PATTERN (p), exit_label)))
+      break;
+    else if (GET_CODE (p) == INSN || GET_CODE (p) == JUMP_INSN
+	     || GET_CODE (p) == CALL_INSN)
+      count_reg_refs (PATTERN (p), refs, 0, 0, max_reg);
+
+  /* Clear the marks for the next loop.  */
+  for (after = loop_start; after != end; after = NEXT_INSN (after))
+    if (GET_CODE (after) == CODE_LABEL)
+      split_label_inside[CODE_LABEL_NUMBER (after) - split_first_label] = 0;
+
+  if (p != end)
+    return;
+
+  /* Choose the regs to split.  */
+
+  reg_map = (rtx *) alloca (max_reg * sizeof (rtx));
+  bzero (reg_map, max_reg * sizeof (rtx));
+
+  for (i = FIRST_PSEUDO_REGISTER; i < nregs; i++)
+    if (refs[i] >= SPLIT_MIN_LOOP_REFS
+	&& regno_first_uid[i] != 0
+	&& uid_luid[regno_first_uid[i]] < start_luid
+	&& uid_luid[regno_last_uid[i]] > end_luid
+	&& (uid_luid[regno_last_uid[i]] - uid_luid[regno_first_uid[i]]
+	    >= SPLIT_SPAN_RATIO * (end_luid - start_luid)))
+      {
+	reg_map[i] = gen_reg_rtx (GET_MODE (regno_reg_rtx[i]));
+	if (REGNO_POINTER_FLAG (i))
+	  mark_reg_pointer (reg_map[i]);
+	nsplit++;
+      }
+
+  if (nsplit == 0)
+    return;
+
+  /* Use the new regs within the loop.  Copy each pattern first,
+     since parts of it may be shared with insns outside the loop.  */
+
+  for (p = loop_start; p != end; p = NEXT_INSN (p))
+    if ((GET_CODE (p) == INSN || GET_CODE (p) == JUMP_INSN
+	 || GET_CODE (p) == CALL_INSN)
+	&& split_reg_mentioned_p (PATTERN (p), reg_map))
+      {
+	register rtx link;
+	PATTERN (p) = replace_regs (copy_rtx (PATTERN (p)), reg_map);
+	INSN_CODE (p) = -1;
+	for (link = REG_NOTES (p); link; link = XEXP (link, 1))
+	  if (GET_CODE (link) == EXPR_LIST && XEXP (link, 0) != 0)
+	    XEXP (link, 0) = replace_regs (copy_rtx (XEXP (link, 0)), reg_map);
+      }
+
+  /* Copy in before the loop and back out after it.  */
+
+  after = exit_label ? exit_label : end;
+  for (i = FIRST_PSEUDO_REGISTER; i < nregs; i++)
+    if (reg_map[i] != 0)
+      {
+	rtx old = regno_reg_rtx[i];
+
+	emit_insn_before (gen_rtx (SET, VOIDmode, reg_map[i], old),
+			  loop_start);
+	emit_insn_after (gen_rtx (SET, VOIDmode, old, reg_map[i]), after);
+
+	if (n_split_regs + 3 > split_regs_size)
+	  {
+	    split_regs_size = 2 * split_regs_size + 30;
+	    if (split_regs)
+	      split_regs = (int *) xrealloc (split_regs,
+					     split_regs_size * sizeof (int));
+	    else
+	      split_regs = (int *) xmalloc (split_regs_size * sizeof (int));
+	  }
+	split_regs[n_split_regs++] = i;
+	split_regs[n_split_regs++] = REGNO (reg_map[i]);
+	split_regs[n_split_regs++] = INSN_UID (loop_start);
+      }
+}
+
+/* Return nonzero if X mentions a reg that REG_MAP would replace.  */
+
+static int
+split_reg_mentioned_p (x, reg_map)
+     rtx x;
+     rtx *reg_map;
+{
+  register RTX_CODE code = GET_CODE (x);
+  register int i;
+  register char *fmt;
+
+  if (code == REG)
+    return reg_map[REGNO (x)] != 0;
+
+  fmt = GET_RTX_FORMAT (code);
+  for (i = GET_RTX_LENGTH (code) - 1; i >= 0; i--)
+    {
+      if (fmt[i] == 'e')
+	{
+	  if (split_reg_mentioned_p (XEXP (x, i), reg_map))
+	    return 1;
+	}
+      else if (fmt[i] == 'E')
+	{
+	  register int j;
+	  for (j = 0; j < XVECLEN (x, i); j++)
+	    if (split_reg_mentioned_p (XVECEXP (x, i, j), reg_map))
+	      return 1;
+	}
+    }
+  return 0;
+}
+
+/* Print on FILE the live range splits made in the current function,
+   with the hard regs that the pieces got.  This is called after
+   global-alloc, so that `reg_renumber' is final.  */
+
+void
+dump_live_range_splits (file)
+     FILE *file;
+{
+  register int i;
+
+  if (n_split_regs == 0)
+    return;
+
+  for (i = 0; i < n_split_regs; i += 3)
+    {
+      int old = split_regs[i], new = split_regs[i + 1];
+
+      fprintf (file, ";; Reg %d split at loop %d into reg %d: ",
+	       old, split_regs[i + 2], new);
+      if (reg_renumber[old] >= 0)
+	fprintf (file, "outside in %d, ", reg_renumber[old]);
+      else
+	fprintf (file, "outside in memory, ");
+      if (reg_renumber[new] >= 0)
+	fprintf (file, "inside in %d.\n", reg_renumber[new]);
+      else
+	fprintf (file, "inside in memory.\n");
+    }
+  fprintf (file, "\n");
+}
@@ -57,6 +57,205 @@ recog_memoized (insn)
     INSN_CODE (insn) = recog (PATTERN (insn), insn);
   return INSN_CODE (insn);
 }
+
+/* Cache of the results of `recog' on patterns that are not in any insn
+   yet, such as the combinations tried by combine.c, which often build
+   the same pattern many times over.
+
+   Each entry is keyed by a flattened copy of the pattern: one word for
+   the code and mode of each rtx, followed by its integer operands.
+   Pseudo registers, symbols and labels are numbered in the order they
+   first appear, so two patterns that differ only by a consistent
+   renaming of those get the same key.  This is valid because the
+   predicates, before reload, treat all pseudo registers alike, and
+   because recognition compares them (in `match_dup') only with each
+   other.  Hard registers keep their numbers.
+
+   The table is direct-mapped: a new key simply replaces whatever
+   entry was in its slot.  Patterns whose key would exceed
+   RECOG_KEY_MAX words are not cached.  */
+
+#ifndef RECOG_CACHE_SIZE
+#define RECOG_CACHE_SIZE 256
+#endif
+
+#define RECOG_KEY_MAX 64
+
+struct recog_cache_entry
+{
+  unsigned hash;		/* hash code of the key */
+  int length;			/* number of words in the key; 0 if empty */
+  int *key;			/* the key itself */
+  int insn_code;		/* what `recog' returned */
+};
+
+static struct recog_cache_entry recog_cache[RECOG_CACHE_SIZE];
+
+/* The key being built by make_recog_key, and its length.  */
+
+static int recog_key[RECOG_KEY_MAX];
+static int recog_key_length;
+
+/* The pseudo registers, symbols and labels seen so far
+   by make_recog_key, in order of appearance.  */
+
+static rtx recog_key_names[RECOG_KEY_MAX];
+static int recog_key_n_names;
+
+/* Number of lookups in the cache, and how many found their pattern.  */
+
+int recog_cache_lookups;
+int recog_cache_hits;
+
+extern int xmalloc ();
+extern void free ();
+
+/* Return the number under which X, a pseudo REG, a SYMBOL_REF or a
+   LABEL_REF, goes in the key being made: its position among the
+   ones already seen which `rtx_equal_p' would call equal to it.  */
+
+static int
+recog_key_name (x)
+     rtx x;
+{
+  register int i;
+
+  for (i = 0; i < recog_key_n_names; i++)
+    if (GET_CODE (recog_key_names[i]) == GET_CODE (x)
+	&& rtx_equal_p (recog_key_names[i], x))
+      return i;
+
+  recog_key_names[recog_key_n_names++] = x;
+  return i;
+}
+
+/* Append the flattened form of X to recog_key.
+   Return 0 if it does not fit or contains something not handled.  */
+
+static int
+make_recog_key (x)
+     rtx x;
+{
+  register RTX_CODE code;
+  register char *fmt;
+  register int i, j;
+
+  if (recog_key_length + 3 > RECOG_KEY_MAX)
+    return 0;
+
+  if (x == 0)
+    {
+      recog_key[recog_key_length++] = -1;
+      return 1;
+    }
+
+  code = GET_CODE (x);
+
+  /* Some rtx's are recognized by their addresses, not their contents.  */
+  recog_key[recog_key_length++]
+    = ((int) code + ((int) GET_MODE (x) << 8)
+       + ((x == const0_rtx || x == const1_rtx
+	   || x == fconst0_rtx || x == dconst0_rtx
+	   || x == pc_rtx || x == cc0_rtx) << 16));
+
+  switch (code)
+    {
+    case REG:
+      if (REGNO (x) < FIRST_PSEUDO_REGISTER)
+	{
+	  recog_key[recog_key_length++] = REGNO (x);
+	  return 1;
+	}
+      /* A pseudo register is numbered like a symbol.  */
+    case SYMBOL_REF:
+    case LABEL_REF:
+      recog_key[recog_key_length++]
+	= FIRST_PSEUDO_REGISTER + recog_key_name (x);
+      return 1;
+
+    case CONST_DOUBLE:
+      recog_key[recog_key_length++] = XINT (x, 0);
+      recog_key[recog_key_length++] = XINT (x, 1);
+      return 1;
+    }
+
+  fmt = GET_RTX_FORMAT (code);
+  for (i = 0; i < GET_RTX_LENGTH (code); i++)
+    switch (fmt[i])
+      {
+      case 'e':
+	if (! make_recog_key (XEXP (x, i)))
+	  return 0;
+	break;
+
+      case 'E':
+	if (recog_key_length == RECOG_KEY_MAX)
+	  return 0;
+	recog_key[recog_key_length++] = XVECLEN (x, i);
+	for (j = 0; j < XVECLEN (x, i); j++)
+	  if (! make_recog_key (XVECEXP (x, i, j)))
+	    return 0;
+	break;
+
+      case 'i':
+	if (recog_key_length == RECOG_KEY_MAX)
+	  return 0;
+	recog_key[recog_key_length++] = XINT (x, i);
+	break;
+
+      case '0':
+	break;
+
+      default:
+	return 0;
+      }
+
+  return 1;
+}
+
+/* Return what `recog' would return for the pattern PAT of insn INSN,
+   looking it up first in the cache of previous results.
+   Unlike `recog', this does not necessarily set `recog_operand';
+   use it only when the insn code is all that is wanted.  */
+
+int
+recog_cached (pat, insn)
+     rtx pat, insn;
+{
+  register unsigned hash = 0;
+  register int i;
+  register struct recog_cache_entry *entry;
+
+  recog_key_length = 0;
+  recog_key_n_names = 0;
+  if (! make_recog_key (pat))
+    return recog (pat, insn);
+
+  for (i = 0; i < recog_key_length; i++)
+    hash = hash * 31 + recog_key[i];
+  hash = (hash * 0x9e3779b1) >> 8;
+
+  recog_cache_lookups++;
+  entry = &recog_cache[hash & (RECOG_CACHE_SIZE - 1)];
+  if (entry->length == recog_key_length && entry->hash == hash
+      && ! bcmp (entry->key, recog_key, recog_key_length * sizeof (int)))
+    {
+      recog_cache_hits++;
+      return entry->insn_code;
+    }
+
+  if (entry->length < recog_key_length)
+    {
+      if (entry->key)
+	free (entry->key);
+      entry->key = (int *) xmalloc (recog_key_length * sizeof (int));
+    }
+  bcopy (recog_key, entry->key, recog_key_length * sizeof (int));
+  entry->length = recog_key_length;
+  entry->hash = hash;
+  entry->insn_code = recog (pat, insn);
+  return entry->insn_code;
+}
 
 /* Return 1 if the insn following INSN does not contain
    any ordered tests applied to the condition codes.
@@ -31,8 +31,14 @@ extern rtx recog_addr_dummy;
 
 extern int recog ();
 
+extern int recog_cached ();
+
+extern int recog_cache_lookups, recog_cache_hits;
+
 extern char *insn_template[];
 
+extern char *insn_template_ops[];
+
 extern int insn_n_operands[];
 
 extern int insn_n_dups[];
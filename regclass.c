@@ -55,12 +55,12 @@ static enum reg_class reg_class_subclasses[N_REG_CLASSES][N_REG_CLASSES]
 /* Indexed by pseudo register number, gives uid of first insn using the reg
    (as of the time reg_scan is called).  */
 
-short *regno_first_uid;
+int *regno_first_uid;
 
 /* Indexed by pseudo register number, gives uid of last insn using the reg
    (as of the time reg_scan is called).  */
 
-short *regno_last_uid;
+int *regno_last_uid;
 
 void reg_class_record ();
 void record_address_regs ();
@@ -453,11 +453,11 @@ reg_scan (f, nregs)
      before regclass is run.  */
   prefclass = 0;
 
-  regno_first_uid = (short *) oballoc (nregs * sizeof (short));
-  bzero (regno_first_uid, nregs * sizeof (short));
+  regno_first_uid = (int *) oballoc (nregs * sizeof (int));
+  bzero (regno_first_uid, nregs * sizeof (int));
 
-  regno_last_uid = (short *) oballoc (nregs * sizeof (short));
-  bzero (regno_last_uid, nregs * sizeof (short));
+  regno_last_uid = (int *) oballoc (nregs * sizeof (int));
+  bzero (regno_last_uid, nregs * sizeof (int));
 
   for (insn = f; insn; insn = NEXT_INSN (insn))
     if (GET_CODE (insn) == INSN
@@ -36,11 +36,11 @@ extern int max_regno;
 /* Indexed by n, gives number of times (REG n) is used or set.
    References within loops may be counted more times.  */
 
-extern short *reg_n_refs;
+extern int *reg_n_refs;
 
 /* Indexed by n, gives number of times (REG n) is set.  */
 
-extern short *reg_n_sets;
+extern int *reg_n_sets;
 
 /* Indexed by N, gives number of insns in which register N dies.
    Note that if register N is live around loops, it can die
@@ -48,7 +48,7 @@ extern short *reg_n_sets;
    So this is only a reliable indicator of how many regions of life there are
    for registers that are contained in one basic block.  */
 
-extern short *reg_n_deaths;
+extern int *reg_n_deaths;
 
 /* Get the number of consecutive words required to hold pseudo-reg N.  */
 
@@ -88,12 +88,12 @@ extern char regs_ever_live[FIRST_PSEUDO_REGISTER];
 /* Vector indexed by regno; gives uid of first insn using that reg.
    This is computed by reg_scan and not adjusted for subsequent changes. */
 
-extern short *regno_first_uid;
+extern int *regno_first_uid;
 
 /* Vector indexed by regno; gives uid of last insn using that reg.
    This is computed by reg_scan and not adjusted for subsequent changes. */
 
-extern short *regno_last_uid;
+extern int *regno_last_uid;
 
 /* Vector indexed by regno; contains 1 for a register is considered a pointer.
    Reloading, etc. will use a pointer register rather than a non-pointer
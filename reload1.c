@@ -50,6 +50,12 @@ and this notice must be preserved on all copies.  */
    insns, requiring additional need for reloads, so we must keep checking
    until the process stabilizes.
 
+   When the register allocation was done by global_alloc, the life of
+   each hard reg is known from the basic block information and the
+   death notes, and a reload can often use a hard reg that is simply
+   not live at the insn being reloaded.  Only the reloads that cannot
+   do so count toward the need for spill regs.
+
    For machines with different classes of registers, we must keep track
    of the register class needed for each reload, and make sure that
    we allocate enough reload registers of each class.
@@ -130,10 +136,87 @@ static char fixed_regs[] = FIXED_REGISTERS;
 
 static char call_clobbered_regs[] = CALL_USED_REGISTERS;
 
+/* Nonzero while the lives of the hard regs are being followed through
+   the insns, so that a reload can use a hard reg that is not live at
+   the insn being reloaded instead of a spill reg.  This is possible
+   only when flow analysis has left basic_block_live_at_start.  */
+static int local_regs_known;
+
+/* The hard regs live before the insn being scanned, and the number
+   of the next basic block whose head the scan will reach.  */
+static HARD_REG_SET reload_hard_live;
+static int reload_next_block;
+
+/* The hard regs that a reload of the insn being scanned may use
+   without spilling: neither live at the insn nor mentioned in it.  */
+static HARD_REG_SET local_free_regs;
+
+/* For each reload of the current insn, the hard reg that
+   choose_local_regs picked for it, or -1 if it needs a spill reg.  */
+static short local_reload_reg[FIRST_PSEUDO_REGISTER];
+
+/* The hard regs that choose_local_regs gave to reloads.  */
+static HARD_REG_SET local_regs_taken;
+
+/* Statistics for the dump file: reloads given locally free regs
+   and reloads given spill regs, and pseudos displaced by spilling,
+   with how many of those found no other hard reg.  */
+static int n_local_reloads;
+static int n_spill_reloads;
+static int n_pseudos_spilled;
+static int n_pseudos_to_stack;
+
+/* More statistics: reloads that found their value already in a reg,
+   how many of those found it in a spill reg loaded before a label or
+   call insn, and how many insns were emitted to load reload regs.  */
+static int n_inherited_reloads;
+static int n_inherited_far;
+static int n_reload_loads;
+
+/* During reload_as_needed, nonzero for a spill reg whose contents,
+   as recorded in reg_reloaded_contents, were kept past a label
+   or a call insn.  In parallel with spill_regs.  */
+static char reg_reloaded_far[FIRST_PSEUDO_REGISTER];
+
+/* During reload_as_needed, information about the labels of the
+   function, indexed by label number less first_reload_label:
+   the number of references to each label from the insns;
+   the insn that refers to the label, if there is only one;
+   and, for a label whose only reference is a jump insn,
+   the index of its entry in the tables below, or -1.  */
+static int first_reload_label;
+static int n_reload_labels;
+static int *label_ref_count;
+static rtx *label_ref_insn;
+static int *label_state_index;
+
+/* For each label that only one jump insn refers to, the contents of
+   the spill regs just after that jump, as reg_reloaded_contents and
+   the corresponding elements of reg_last_reload_reg, with N_SPILLS
+   elements per label, and nonzero in label_state_saved once they
+   are recorded.  */
+static int *label_reloaded_contents;
+static rtx *label_reloaded_regs;
+static char *label_state_saved;
+
+/* EXPR_LIST of the REGs and MEMs that the function refers to
+   inside a VOLATILE, noted before find_reloads removes the VOLATILEs.
+   reload_cse_regs never treats these as slots.  */
+static rtx volatile_slots;
+
 static void reload_as_needed ();
 static void choose_reload_targets ();
 static void forget_old_reloads ();
 static void order_regs_for_reload ();
+static void start_local_regs ();
+static void scan_local_regs ();
+static void choose_local_regs ();
+static void count_label_refs ();
+static void save_reloads_at_jump ();
+static void keep_reloads_at_label ();
+static void keep_reloads_at_call ();
+static int reload_reg_class_lower_p ();
+static void note_volatile_slots ();
 
 /* Main entry point for the reload pass, and only entry point
    in this file.
@@ -163,6 +246,16 @@ reload (first, global, dumpfile)
 
   int something_changed;
   int something_needs_reloads;
+  rtx insn;
+
+  /* find_reloads removes the VOLATILEs, but reload_cse_regs must still
+     leave volatile slots alone; so note now which they are.  */
+
+  volatile_slots = 0;
+  for (insn = first; insn; insn = NEXT_INSN (insn))
+    if (GET_CODE (insn) == INSN || GET_CODE (insn) == JUMP_INSN
+	|| GET_CODE (insn) == CALL_INSN)
+      note_volatile_slots (PATTERN (insn));
 
   /* Compute which hard registers are now in use
      as homes for pseudo registers.
@@ -195,6 +288,14 @@ reload (first, global, dumpfile)
 
   order_regs_for_reload ();
 
+  n_local_reloads = 0;
+  n_spill_reloads = 0;
+  n_pseudos_spilled = 0;
+  n_pseudos_to_stack = 0;
+  n_inherited_reloads = 0;
+  n_inherited_far = 0;
+  n_reload_loads = 0;
+
   /* So far, no hard regs have been spilled.  */
   n_spills = 0;
   for (i = 0; i < FIRST_PSEUDO_REGISTER; i++)
@@ -222,10 +323,14 @@ reload (first, global, dumpfile)
       bzero (max_needs, sizeof max_needs);
 
       /* Compute the most additional registers needed by any instruction.
-	 Collect information separately for each class of regs.  */
+	 Collect information separately for each class of regs.
+	 The hard regs free at each insn depend on where the pseudos
+	 are now, so they are recomputed on every pass.  */
 
+      start_local_regs (global);
       for (insn = first; insn; insn = NEXT_INSN (insn))
 	{
+	  scan_local_regs (insn);
 	  if (GET_CODE (insn) == INSN || GET_CODE (insn) == JUMP_INSN
 	      || GET_CODE (insn) == CALL_INSN)
 	    {
@@ -267,6 +372,10 @@ reload (first, global, dumpfile)
 
 	      something_needs_reloads = 1;
 
+	      /* Find the reloads that can use a hard reg free at this insn.  */
+
+	      choose_local_regs ();
+
 	      /* Count each reload once in every class
 		 containing the reload's own class.  */
 
@@ -275,9 +384,11 @@ reload (first, global, dumpfile)
 		  register enum reg_class *p;
 		  /* Don't count the dummy reloads, for which one of the
 		     regs mentioned in the insn can be used for reloading.
-		     Don't count optional reloads.  */
+		     Don't count optional reloads, or those that
+		     can use a reg that is free here.  */
 		  if (reload_reg_rtx[i] != 0
-		      || reload_optional[i] != 0)
+		      || reload_optional[i] != 0
+		      || local_reload_reg[i] >= 0)
 		    continue;
 		  insn_needs[(int) reload_reg_class[i]]++;
 		  p = reg_class_superclasses[(int) reload_reg_class[i]];
@@ -379,6 +490,9 @@ reload (first, global, dumpfile)
 		      /* Update regs_ever_live for new home (if any).  */
 		      mark_home_live (i);
 		    }
+		  n_pseudos_spilled++;
+		  if (reg_renumber[i] == -1)
+		    n_pseudos_to_stack++;
 		  if (dumpfile)
 		    {
 		      if (reg_renumber[i] == -1)
@@ -392,6 +506,11 @@ reload (first, global, dumpfile)
 		}
 	    regs_ever_live[spill_regs[n_spills]] = 1;
 	    n_spills++;
+
+	    /* A new spill reg is no longer free for local use,
+	       so the needs must be counted again.  */
+	    if (local_regs_known)
+	      something_changed = 1;
 	}
     }
 
@@ -401,6 +520,14 @@ reload (first, global, dumpfile)
 
   if (something_needs_reloads)
     reload_as_needed (first, n_spills, global);
+
+  if (dumpfile)
+    fprintf (dumpfile, ";; Reload: %d spill regs, %d pseudos spilled (%d to the stack),\n;; %d reloads into locally free regs, %d into spill regs.\n\n",
+	     n_spills, n_pseudos_spilled, n_pseudos_to_stack,
+	     n_local_reloads, n_spill_reloads);
+  if (dumpfile)
+    fprintf (dumpfile, ";; %d reloads inherited (%d past a label or call), %d reload insns emitted.\n\n",
+	     n_inherited_reloads, n_inherited_far, n_reload_loads);
 }
 
 /* Mark the slots in regs_ever_live for the hard regs
@@ -520,11 +647,61 @@ wins:
   reg_last_reload_reg = (rtx *) alloca (max_regno * sizeof (rtx));
   bzero (reg_last_reload_reg, max_regno * sizeof (rtx));
   for (i = 0; i < n_spills; i++)
-    reg_reloaded_contents[i] = -1;
+    {
+      reg_reloaded_contents[i] = -1;
+      reg_reloaded_far[i] = 0;
+    }
+
+  /* Find the range of the label numbers in this function
+     and count the references to each label.  */
+
+  {
+    register int last_label = -1;
+    register int n_saved = 0;
+
+    first_reload_label = -1;
+    for (insn = first; insn; insn = NEXT_INSN (insn))
+      if (GET_CODE (insn) == CODE_LABEL)
+	{
+	  if (first_reload_label < 0
+	      || CODE_LABEL_NUMBER (insn) < first_reload_label)
+	    first_reload_label = CODE_LABEL_NUMBER (insn);
+	  if (CODE_LABEL_NUMBER (insn) > last_label)
+	    last_label = CODE_LABEL_NUMBER (insn);
+	}
+    n_reload_labels = last_label - first_reload_label + 1;
+
+    label_ref_count = (int *) alloca (n_reload_labels * sizeof (int));
+    label_ref_insn = (rtx *) alloca (n_reload_labels * sizeof (rtx));
+    label_state_index = (int *) alloca (n_reload_labels * sizeof (int));
+    bzero (label_ref_count, n_reload_labels * sizeof (int));
+    bzero (label_ref_insn, n_reload_labels * sizeof (rtx));
+
+    for (insn = first; insn; insn = NEXT_INSN (insn))
+      if (GET_CODE (insn) == INSN || GET_CODE (insn) == JUMP_INSN
+	  || GET_CODE (insn) == CALL_INSN)
+	count_label_refs (PATTERN (insn), insn);
+
+    for (i = 0; i < n_reload_labels; i++)
+      if (label_ref_count[i] == 1
+	  && GET_CODE (label_ref_insn[i]) == JUMP_INSN)
+	label_state_index[i] = n_saved++;
+      else
+	label_state_index[i] = -1;
 
+    label_reloaded_contents
+      = (int *) alloca (n_saved * n_spills * sizeof (int));
+    label_reloaded_regs = (rtx *) alloca (n_saved * n_spills * sizeof (rtx));
+    label_state_saved = (char *) alloca (n_saved);
+    bzero (label_state_saved, n_saved);
+  }
+
+  start_local_regs (live_known);
   for (insn = first; insn;)
     {
       register rtx next = NEXT_INSN (insn);
+      /* This must look at INSN before find_reloads alters it.  */
+      scan_local_regs (insn);
       if (GET_CODE (insn) == INSN || GET_CODE (insn) == JUMP_INSN
 	  || GET_CODE (insn) == CALL_INSN)
 	{
@@ -558,17 +735,185 @@ wins:
 	     registers ARE still valid.  */
 	  forget_old_reloads (PATTERN (insn));
 	}
-      /* Don't assume a spilled reg is still good after a call insn;
-	 it could be (and probably is) a call_clobbered_reg.  */
-      if (GET_CODE (insn) == CODE_LABEL || GET_CODE (insn) == CALL_INSN)
+      /* Remember what the spill regs hold where this jump goes,
+	 in case no other insn goes there.  */
+      if (GET_CODE (insn) == JUMP_INSN)
+	save_reloads_at_jump (insn, n_spills);
+      /* At a label, keep what the spill regs hold only if control
+	 can reach the label from just one place.  */
+      if (GET_CODE (insn) == CODE_LABEL)
+	keep_reloads_at_label (insn, n_spills);
+      /* Don't assume a spilled reg is still good after a call insn
+	 if it is a call_clobbered_reg.  */
+      if (GET_CODE (insn) == CALL_INSN)
+	keep_reloads_at_call (n_spills);
+      insn = next;
+    }
+}
+
+/* Count each reference to a label in X, which is part of INSN,
+   in label_ref_count, and note INSN in label_ref_insn.  */
+
+static void
+count_label_refs (x, insn)
+     rtx x;
+     rtx insn;
+{
+  register RTX_CODE code = GET_CODE (x);
+  register char *fmt;
+  register int i, j;
+
+  if (code == LABEL_REF)
+    {
+      i = CODE_LABEL_NUMBER (XEXP (x, 0)) - first_reload_label;
+      if (i >= 0 && i < n_reload_labels)
 	{
-	  for (i = 0; i < n_spills; i++)
-	    reg_reloaded_contents[i] = -1;
+	  label_ref_count[i]++;
+	  label_ref_insn[i] = insn;
 	}
-      insn = next;
+      return;
+    }
+
+  fmt = GET_RTX_FORMAT (code);
+  for (i = GET_RTX_LENGTH (code) - 1; i >= 0; i--)
+    {
+      if (fmt[i] == 'e')
+	count_label_refs (XEXP (x, i), insn);
+      else if (fmt[i] == 'E')
+	for (j = XVECLEN (x, i) - 1; j >= 0; j--)
+	  count_label_refs (XVECEXP (x, i, j), insn);
     }
 }
 
+/* Return the index in the label tables of LABEL, a CODE_LABEL,
+   or -1 if it is not a label of this function.  */
+
+static int
+reload_label_index (label)
+     rtx label;
+{
+  register int i = CODE_LABEL_NUMBER (label) - first_reload_label;
+  if (i < 0 || i >= n_reload_labels)
+    return -1;
+  return i;
+}
+
+/* JUMP, a jump insn, has just been reloaded.  If it is the only insn
+   that refers to its label, record the contents of the spill regs
+   so that they can be used again at the label.  */
+
+static void
+save_reloads_at_jump (jump, n_spills)
+     rtx jump;
+     int n_spills;
+{
+  register int i, n;
+  register int *contents;
+  register rtx *regs;
+
+  if (JUMP_LABEL (jump) == 0
+      || (n = reload_label_index (JUMP_LABEL (jump))) < 0
+      || label_ref_insn[n] != jump
+      || label_state_index[n] < 0)
+    return;
+
+  contents = label_reloaded_contents + label_state_index[n] * n_spills;
+  regs = label_reloaded_regs + label_state_index[n] * n_spills;
+  for (i = 0; i < n_spills; i++)
+    {
+      contents[i] = reg_reloaded_contents[i];
+      regs[i] = contents[i] >= 0 ? reg_last_reload_reg[contents[i]] : 0;
+    }
+  label_state_saved[label_state_index[n]] = 1;
+}
+
+/* Decide what the spill regs are known to hold at LABEL.
+   If the label is reached only by falling into it, they still hold
+   what they held before it.  If it is reached only by one jump that
+   was reloaded earlier, they hold what they held after the jump.
+   Otherwise nothing is known.
+
+   No store into a pseudo is deleted because of a reload inherited
+   past a label, since other paths may need the stored value.  */
+
+static void
+keep_reloads_at_label (label, n_spills)
+     rtx label;
+     int n_spills;
+{
+  register int i;
+  register int n = reload_label_index (label);
+  register rtx prev;
+  int falls_in;
+
+  for (prev = PREV_INSN (label); prev; prev = PREV_INSN (prev))
+    if (GET_CODE (prev) != NOTE)
+      break;
+  falls_in = (prev == 0 || GET_CODE (prev) != BARRIER);
+
+  for (i = 0; i < n_spills; i++)
+    spill_reg_store[i] = 0;
+
+  if (n >= 0 && falls_in && label_ref_count[n] == 0)
+    {
+      for (i = 0; i < n_spills; i++)
+	if (reg_reloaded_contents[i] >= 0)
+	  reg_reloaded_far[i] = 1;
+    }
+  else if (n >= 0 && ! falls_in && label_state_index[n] >= 0
+	   && label_state_saved[label_state_index[n]])
+    {
+      register int *contents
+	= label_reloaded_contents + label_state_index[n] * n_spills;
+      register rtx *regs
+	= label_reloaded_regs + label_state_index[n] * n_spills;
+
+      for (i = 0; i < n_spills; i++)
+	{
+	  reg_reloaded_contents[i] = regs[i] != 0 ? contents[i] : -1;
+	  reg_reloaded_far[i] = 0;
+	  if (regs[i] != 0)
+	    {
+	      reg_last_reload_reg[contents[i]] = regs[i];
+	      reg_reloaded_far[i] = 1;
+	    }
+	}
+    }
+  else
+    for (i = 0; i < n_spills; i++)
+      reg_reloaded_contents[i] = -1;
+}
+
+/* A call insn has just been reloaded.  Forget the contents of the
+   spill regs that the call may clobber, but keep the others.  */
+
+static void
+keep_reloads_at_call (n_spills)
+     int n_spills;
+{
+  register int i;
+
+  for (i = 0; i < n_spills; i++)
+    if (reg_reloaded_contents[i] >= 0)
+      {
+	register rtx reg = reg_last_reload_reg[reg_reloaded_contents[i]];
+	register int regno = spill_regs[i];
+	register int last;
+	int clobbered = (reg == 0);
+
+	if (reg != 0)
+	  for (last = regno + HARD_REGNO_NREGS (regno, GET_MODE (reg));
+	       regno < last; regno++)
+	    if (call_clobbered_regs[regno])
+	      clobbered = 1;
+
+	if (clobbered)
+	  reg_reloaded_contents[i] = -1;
+	else
+	  reg_reloaded_far[i] = 1;
+      }
+}
+
 /* If we see a pseudo-reg being stored into,
    don't try to reuse an old reload reg
    which previously contained a copy of it.  */
@@ -597,6 +942,284 @@ forget_old_reloads (x)
     }
 }
 
+/* Prepare to follow the lives of the hard regs from the start of the
+   function, if LIVE_KNOWN says flow analysis has computed them.  */
+
+static void
+start_local_regs (live_known)
+     int live_known;
+{
+  local_regs_known = (live_known && n_basic_blocks > 0
+		      && basic_block_live_at_start != 0);
+  reload_next_block = 0;
+  CLEAR_HARD_REG_SET (reload_hard_live);
+  CLEAR_HARD_REG_SET (local_free_regs);
+}
+
+/* Mark the hard regs that REGNO occupies in mode MODE
+   as live (if LIVE is nonzero) or dead in reload_hard_live.  */
+
+static void
+mark_hard_live (regno, mode, live)
+     register int regno;
+     enum machine_mode mode;
+     int live;
+{
+  register int last = regno + HARD_REGNO_NREGS (regno, mode);
+  while (regno < last)
+    {
+      if (live)
+	SET_HARD_REG_BIT (reload_hard_live, regno);
+      else
+	CLEAR_HARD_REG_BIT (reload_hard_live, regno);
+      regno++;
+    }
+}
+
+/* Same, for the register rtx REG, which may be a pseudo
+   that has a hard reg or none.  */
+
+static void
+mark_hard_live_reg (reg, live)
+     rtx reg;
+     int live;
+{
+  register int regno = REGNO (reg);
+
+  if (regno >= FIRST_PSEUDO_REGISTER)
+    {
+      if (reg_renumber[regno] < 0)
+	return;
+      mark_hard_live (reg_renumber[regno], PSEUDO_REGNO_MODE (regno), live);
+    }
+  else
+    mark_hard_live (regno, GET_MODE (reg), live);
+}
+
+/* Remove from local_free_regs every hard reg that X refers to,
+   directly or through a pseudo reg allocated to it.  */
+
+static void
+clear_mentioned_regs (x)
+     rtx x;
+{
+  register RTX_CODE code = GET_CODE (x);
+  register char *fmt;
+  register int i, j;
+
+  if (code == REG)
+    {
+      register int regno = REGNO (x);
+      register enum machine_mode mode = GET_MODE (x);
+      register int last;
+
+      if (regno >= FIRST_PSEUDO_REGISTER)
+	{
+	  if (reg_renumber[regno] < 0)
+	    return;
+	  mode = PSEUDO_REGNO_MODE (regno);
+	  regno = reg_renumber[regno];
+	}
+      last = regno + HARD_REGNO_NREGS (regno, mode);
+      while (regno < last)
+	CLEAR_HARD_REG_BIT (local_free_regs, regno++);
+      return;
+    }
+
+  fmt = GET_RTX_FORMAT (code);
+  for (i = GET_RTX_LENGTH (code) - 1; i >= 0; i--)
+    {
+      if (fmt[i] == 'e')
+	clear_mentioned_regs (XEXP (x, i));
+      else if (fmt[i] == 'E')
+	for (j = XVECLEN (x, i) - 1; j >= 0; j--)
+	  clear_mentioned_regs (XVECEXP (x, i, j));
+    }
+}
+
+/* Mark as live a hard reg set by the SET or CLOBBER X.  */
+
+static void
+mark_hard_live_set (x)
+     rtx x;
+{
+  register rtx dest;
+
+  if (GET_CODE (x) != SET)
+    return;
+  dest = SET_DEST (x);
+  if (GET_CODE (dest) == SUBREG)
+    dest = SUBREG_REG (dest);
+  if (GET_CODE (dest) == REG)
+    mark_hard_live_reg (dest, 1);
+}
+
+/* Advance the scan of the hard regs' lives to INSN,
+   which must be the next insn after the previous one scanned.
+   If INSN is an insn, set local_free_regs to the hard regs that a
+   reload of INSN can use without spilling anything, and then update
+   reload_hard_live past INSN, in the same way global_conflicts does.
+   This must be done before find_reloads has altered INSN.
+
+   A reg qualifies only if it is already in use in this function,
+   so that using it costs no new save in the prologue, and if it is
+   not a spill reg, which would hold values reload keeps track of.  */
+
+static void
+scan_local_regs (insn)
+     rtx insn;
+{
+  register RTX_CODE code = GET_CODE (insn);
+  register rtx link;
+  register int i;
+
+  if (! local_regs_known)
+    return;
+
+  if (reload_next_block < n_basic_blocks
+      && insn == basic_block_head[reload_next_block])
+    {
+      register regset live = basic_block_live_at_start[reload_next_block++];
+
+      CLEAR_HARD_REG_SET (reload_hard_live);
+      EXECUTE_IF_SET_IN_REG_SET
+	(live, i,
+	 {
+	   if (i < FIRST_PSEUDO_REGISTER)
+	     SET_HARD_REG_BIT (reload_hard_live, i);
+	   else if (reg_renumber[i] >= 0)
+	     mark_hard_live (reg_renumber[i], PSEUDO_REGNO_MODE (i), 1);
+	 });
+    }
+
+  if (code != INSN && code != JUMP_INSN && code != CALL_INSN)
+    return;
+
+  CLEAR_HARD_REG_SET (local_free_regs);
+  for (i = 0; i < FIRST_PSEUDO_REGISTER; i++)
+    if (! TEST_HARD_REG_BIT (reload_hard_live, i)
+	&& ! fixed_regs[i] && regs_ever_live[i]
+	&& spill_reg_order[i] < 0
+	&& ! (code == CALL_INSN && call_clobbered_regs[i]))
+      SET_HARD_REG_BIT (local_free_regs, i);
+  clear_mentioned_regs (PATTERN (insn));
+
+  /* Regs set in INSN become live; then those that die in it,
+     or are set and never used, become dead.  */
+
+  if (GET_CODE (PATTERN (insn)) == PARALLEL)
+    for (i = XVECLEN (PATTERN (insn), 0) - 1; i >= 0; i--)
+      mark_hard_live_set (XVECEXP (PATTERN (insn), 0, i));
+  else
+    mark_hard_live_set (PATTERN (insn));
+
+  for (link = REG_NOTES (insn); link; link = XEXP (link, 1))
+    if ((enum reg_note) GET_MODE (link) == REG_DEAD
+	&& GET_CODE (XEXP (link, 0)) == REG)
+      mark_hard_live_reg (XEXP (link, 0), 0);
+}
+
+/* Decide which reloads of the insn just analyzed by find_reloads can
+   use regs in local_free_regs, recording the choices in local_reload_reg
+   and local_regs_taken.  The reloads are taken in the order that
+   choose_reload_targets uses, so that the choices made for the insn
+   when the needs are counted are the same ones made when it is reloaded.  */
+
+static void
+choose_local_regs ()
+{
+  register int j;
+  short reload_order[FIRST_PSEUDO_REGISTER];
+  HARD_REG_SET free;
+
+  CLEAR_HARD_REG_SET (local_regs_taken);
+  for (j = 0; j < n_reloads; j++)
+    {
+      reload_order[j] = j;
+      local_reload_reg[j] = -1;
+    }
+
+  if (! local_regs_known)
+    return;
+
+  if (n_reloads > 1)
+    qsort (reload_order, n_reloads, sizeof (short), reload_reg_class_lower_p);
+
+  COPY_HARD_REG_SET (free, local_free_regs);
+  for (j = 0; j < n_reloads; j++)
+    {
+      register int r = reload_order[j];
+      register int regno, k, nregs;
+
+      if (reload_reg_rtx[r] != 0 || reload_optional[r] != 0)
+	continue;
+
+      for (regno = 0; regno < FIRST_PSEUDO_REGISTER; regno++)
+	if (TEST_HARD_REG_BIT (reg_class_contents[(int) reload_reg_class[r]],
+			       regno)
+	    && HARD_REGNO_MODE_OK (regno, reload_mode[r]))
+	  {
+	    nregs = HARD_REGNO_NREGS (regno, reload_mode[r]);
+	    if (nregs < 1)
+	      nregs = 1;
+	    for (k = 0; k < nregs; k++)
+	      if (regno + k >= FIRST_PSEUDO_REGISTER
+		  || ! TEST_HARD_REG_BIT (free, regno + k))
+		break;
+	    if (k == nregs)
+	      break;
+	  }
+
+      if (regno == FIRST_PSEUDO_REGISTER)
+	continue;
+
+      local_reload_reg[r] = regno;
+      for (k = 0; k < nregs; k++)
+	{
+	  CLEAR_HARD_REG_BIT (free, regno + k);
+	  SET_HARD_REG_BIT (local_regs_taken, regno + k);
+	}
+    }
+}
+
+/* Return nonzero if each reload in ORDER after the Jth one that has
+   no reload reg yet and was not given a locally free reg can still
+   get a spill reg that IN_USE does not mark as taken.
+   This is how choose_reload_targets makes sure that letting a reload
+   counted on to use a free reg use a spill reg instead
+   does not leave a later reload without one.  */
+
+static int
+spill_regs_suffice (order, j, in_use, n_spills)
+     short *order;
+     int j;
+     char *in_use;
+     int n_spills;
+{
+  char taken[FIRST_PSEUDO_REGISTER];
+  register int i;
+
+  bcopy (in_use, taken, FIRST_PSEUDO_REGISTER);
+  for (j++; j < n_reloads; j++)
+    {
+      register int r = order[j];
+
+      if (reload_reg_rtx[r] != 0 || reload_optional[r] != 0
+	  || local_reload_reg[r] >= 0)
+	continue;
+
+      for (i = 0; i < n_spills; i++)
+	if (taken[i] == 0
+	    && TEST_HARD_REG_BIT (reg_class_contents[(int) reload_reg_class[r]],
+				  spill_regs[i]))
+	  break;
+      if (i == n_spills)
+	return 0;
+      taken[i] = 1;
+    }
+  return 1;
+}
+
 static int
 reload_reg_class_lower_p (p1, p2)
      short *p1, *p2;
@@ -654,6 +1277,10 @@ choose_reload_targets (insn, n_spills)
   if (n_reloads > 1)
     qsort (reload_order, n_reloads, sizeof (short), reload_reg_class_lower_p);
 
+  /* Make the same choices of locally free regs
+     that were made when the needs were counted.  */
+  choose_local_regs ();
+
   for (j = 0; j < n_reloads; j++)
     {
       register int r = reload_order[j];
@@ -686,6 +1313,20 @@ choose_reload_targets (insn, n_spills)
 		reload_reg_in_use[i] = 1;
 		reload_inherited[r] = 1;
 		reload_spill_index[r] = i;
+
+		/* A reload that was to use a free reg may take
+		   a spill reg only if that deprives no other reload.  */
+		if (local_reload_reg[r] >= 0
+		    && ! spill_regs_suffice (reload_order, j,
+					     reload_reg_in_use, n_spills))
+		  {
+		    reload_reg_rtx[r] = 0;
+		    reload_reg_in_use[i] = 0;
+		    reload_inherited[r] = 0;
+		    reload_spill_index[r] = -1;
+		  }
+		else if (reg_reloaded_far[i])
+		  n_inherited_far++;
 	      }
 	  }
       }
@@ -696,6 +1337,27 @@ choose_reload_targets (insn, n_spills)
 	{
 	  register rtx equiv
 	    = find_equiv_reg (reload_in[r], insn, reload_reg_class[r], -1, 0);
+
+	  /* Don't use a reg that another reload of this insn
+	     has been given as a locally free reg.  */
+	  if (equiv != 0
+	      && TEST_HARD_REG_BIT (local_regs_taken, REGNO (equiv))
+	      && REGNO (equiv) != local_reload_reg[r])
+	    equiv = 0;
+
+	  /* If it is a spill reg and this reload was to use a free reg,
+	     take the spill reg only if no other reload needs it.  */
+	  if (equiv != 0 && local_reload_reg[r] >= 0
+	      && (i = spill_reg_order[REGNO (equiv)]) >= 0
+	      && ! reload_reg_in_use[i])
+	    {
+	      reload_reg_in_use[i] = 1;
+	      if (! spill_regs_suffice (reload_order, j,
+					reload_reg_in_use, n_spills))
+		equiv = 0;
+	      reload_reg_in_use[i] = 0;
+	    }
+
 	  /* If we found an equivalent reg, say no code need be generated
 	     to load it, and use it as our reload reg.  */
 	  if (equiv != 0)
@@ -704,7 +1366,7 @@ choose_reload_targets (insn, n_spills)
 	      reload_inherited[r] = 1;
 	      /* If it is a spill reg,
 		 mark the spill reg as in use for this insn.  */
-	      if ((i = spill_reg_order[REGNO (equiv)]) != 0)
+	      if ((i = spill_reg_order[REGNO (equiv)]) >= 0)
 		{
 		  reload_reg_in_use[i] = 1;
 		}
@@ -716,6 +1378,15 @@ choose_reload_targets (insn, n_spills)
       if (reload_reg_rtx[r] != 0 || reload_optional[r] != 0)
 	continue;
 
+      /* Use the reg not live here that was chosen for this reload, if any.
+	 Such a reg holds nothing that later insns can inherit.  */
+      if (local_reload_reg[r] >= 0)
+	{
+	  reload_reg_rtx[r] = gen_rtx (REG, reload_mode[r], local_reload_reg[r]);
+	  n_local_reloads++;
+	  continue;
+	}
+
       /* Value not lying around; find a register to reload it into.
 	 Here I is not a regno, it is an index into spill_regs.  */
       for (i = 0; i < n_spills; i++)
@@ -738,6 +1409,8 @@ choose_reload_targets (insn, n_spills)
       reload_reg_rtx[r] = new;
       reload_spill_index[r] = i;
       reg_reloaded_contents[i] = -1;
+      reg_reloaded_far[i] = 0;
+      n_spill_reloads++;
     }
 
   /* Now for all the spill regs newly used in this instruction,
@@ -757,12 +1430,14 @@ choose_reload_targets (insn, n_spills)
 	      register int nregno = REGNO (reload_out[r]);
 	      reg_last_reload_reg[nregno] = reload_reg_rtx[r];
 	      reg_reloaded_contents[i] = nregno;
+	      reg_reloaded_far[i] = 0;
 	    }
 	  if (reload_out[r] == 0 && GET_CODE (reload_in[r]) == REG)
 	    {
 	      register int nregno = REGNO (reload_in[r]);
 	      reg_last_reload_reg[nregno] = reload_reg_rtx[r];
 	      reg_reloaded_contents[i] = nregno;
+	      reg_reloaded_far[i] = 0;
 	    }
 	}
     }
@@ -775,13 +1450,17 @@ choose_reload_targets (insn, n_spills)
   for (j = 0; j < n_reloads; j++)
     {
       register rtx old;
+      rtx store_insn;
 
       old = reload_in[j];
+      if (reload_inherited[j])
+	n_inherited_reloads++;
       if (old != 0 && ! reload_inherited[j]
 	  && reload_reg_rtx[j] != old
 	  && reload_reg_rtx[j] != 0)
 	{
 	  register rtx reloadreg = reload_reg_rtx[j];
+	  n_reload_loads++;
 	  /* Encapsulate RELOADREG so its machine mode matches what
 	     is being copied into it.
 	     Except, if OLD is multiple regs and we are only using one,
@@ -884,10 +1563,442 @@ choose_reload_targets (insn, n_spills)
 	    old = SUBREG_REG (old);
 	  if (GET_MODE (reloadreg) != GET_MODE (old))
 	    reloadreg = gen_rtx (SUBREG, GET_MODE (old), reloadreg, 0);
-	  spill_reg_store[reload_spill_index[j]]
-	    = emit_insn_after (gen_move_insn (old, reloadreg), insn);
+	  store_insn = emit_insn_after (gen_move_insn (old, reloadreg), insn);
+	  if (reload_spill_index[j] >= 0)
+	    spill_reg_store[reload_spill_index[j]] = store_insn;
 	}
-      else
+      else if (reload_spill_index[j] >= 0)
 	spill_reg_store[reload_spill_index[j]] = 0;
     }
 }
+
+/* After reloading, delete the move insns that have become redundant.
+
+   Reloading leaves many copies of pseudos that live on the stack
+   (those with no hard reg) and of slots in the frame: a value stored
+   into a slot is often loaded right back, and loads of the same slot
+   are repeated, because CSE ran before these slots existed.
+   Here we scan each basic block, keeping track of which slot's value
+   each hard reg holds, in the manner of find_equiv_reg, and delete:
+
+   loads into a hard reg that already holds the slot's value;
+   stores of a hard reg into a slot that already holds its value;
+   stores into a stack pseudo that is stored again before being used,
+   with no jump or label in between;
+   and moves of a reg into itself.  */
+
+/* Element N is the slot whose value hard reg N holds, or 0.
+   A slot is a REG for a pseudo that has no hard reg
+   or a MEM addressed by the frame pointer plus a constant.
+   The value has the mode of the slot.  */
+static rtx hard_reg_slot[FIRST_PSEUDO_REGISTER];
+
+/* Indexed by pseudo reg number, the last insn in this basic block
+   that stored into that stack pseudo, if the pseudo has not been
+   used since, or 0.  The pseudos that have such insns are listed
+   in pending_store_regs, with n_pending_stores elements.  */
+static rtx *pending_store;
+static int *pending_store_regs;
+static int n_pending_stores;
+
+/* Add to `volatile_slots' each REG or MEM that appears inside
+   a VOLATILE in X.  */
+
+static void
+note_volatile_slots (x)
+     rtx x;
+{
+  register RTX_CODE code = GET_CODE (x);
+  register int i, j;
+  register char *fmt;
+
+  if (code == VOLATILE)
+    {
+      register rtx y = XEXP (x, 0);
+      if (GET_CODE (y) == REG || GET_CODE (y) == MEM)
+	volatile_slots = gen_rtx (EXPR_LIST, VOIDmode, y, volatile_slots);
+    }
+
+  fmt = GET_RTX_FORMAT (code);
+  for (i = GET_RTX_LENGTH (code) - 1; i >= 0; i--)
+    {
+      if (fmt[i] == 'e')
+	note_volatile_slots (XEXP (x, i));
+      else if (fmt[i] == 'E')
+	for (j = 0; j < XVECLEN (x, i); j++)
+	  note_volatile_slots (XVECEXP (x, i, j));
+    }
+}
+
+/* Return nonzero if X is a slot, as described above,
+   and is not referred to as volatile.  */
+
+static int
+reload_slot_p (x)
+     rtx x;
+{
+  register rtx link;
+
+  if (GET_CODE (x) == REG)
+    {
+      if (REGNO (x) < FIRST_PSEUDO_REGISTER || reg_renumber[REGNO (x)] >= 0)
+	return 0;
+    }
+  else if (GET_CODE (x) == MEM)
+    {
+      register rtx addr = XEXP (x, 0);
+      if (GET_CODE (addr) == PLUS
+	  && GET_CODE (XEXP (addr, 1)) == CONST_INT)
+	addr = XEXP (addr, 0);
+      if (GET_CODE (addr) != REG || REGNO (addr) != FRAME_POINTER_REGNUM)
+	return 0;
+    }
+  else
+    return 0;
+
+  for (link = volatile_slots; link; link = XEXP (link, 1))
+    {
+      register rtx y = XEXP (link, 0);
+      if (GET_CODE (y) == GET_CODE (x)
+	  && (GET_CODE (x) == REG
+	      ? REGNO (y) == REGNO (x)
+	      : rtx_equal_p (XEXP (y, 0), XEXP (x, 0))))
+	return 0;
+    }
+  return 1;
+}
+
+/* Return the hard reg number that X, a REG, refers to, or -1 if none.  */
+
+static int
+reload_hard_regno (x)
+     rtx x;
+{
+  register int regno = REGNO (x);
+
+  if (regno >= FIRST_PSEUDO_REGISTER)
+    return reg_renumber[regno];
+  return regno;
+}
+
+/* Forget the values of hard regs REGNO through REGNO + NREGS - 1,
+   including any multi-word value that overlaps them.  */
+
+static void
+forget_hard_regs (regno, nregs)
+     int regno, nregs;
+{
+  register int i;
+
+  for (i = 0; i < FIRST_PSEUDO_REGISTER; i++)
+    if (hard_reg_slot[i] != 0
+	&& i < regno + nregs
+	&& i + HARD_REGNO_NREGS (i, GET_MODE (hard_reg_slot[i])) > regno)
+      hard_reg_slot[i] = 0;
+}
+
+/* Forget that any hard reg holds the value of the slot X.
+   A store into any memory may change any frame slot, so if X is
+   a MEM, or is 0, forget the values of all the frame slots.  */
+
+static void
+forget_slot (x)
+     rtx x;
+{
+  register int i;
+
+  for (i = 0; i < FIRST_PSEUDO_REGISTER; i++)
+    if (hard_reg_slot[i] != 0
+	&& (x == 0 || GET_CODE (x) == MEM
+	    ? GET_CODE (hard_reg_slot[i]) == MEM
+	    : (GET_CODE (hard_reg_slot[i]) == REG
+	       && REGNO (hard_reg_slot[i]) == REGNO (x))))
+      hard_reg_slot[i] = 0;
+}
+
+/* Update hard_reg_slot for a store into DEST, part of a SET or CLOBBER.  */
+
+static void
+forget_stored_value (dest)
+     rtx dest;
+{
+  while (GET_CODE (dest) == SUBREG
+	 || GET_CODE (dest) == VOLATILE
+	 || GET_CODE (dest) == ZERO_EXTRACT
+	 || GET_CODE (dest) == SIGN_EXTRACT
+	 || GET_CODE (dest) == STRICT_LOW_PART)
+    dest = XEXP (dest, 0);
+
+  if (GET_CODE (dest) == REG)
+    {
+      register int regno = reload_hard_regno (dest);
+      if (regno >= 0)
+	forget_hard_regs (regno, (REGNO (dest) < FIRST_PSEUDO_REGISTER
+				  ? HARD_REGNO_NREGS (regno, GET_MODE (dest))
+				  : HARD_REGNO_NREGS (regno,
+						      PSEUDO_REGNO_MODE (REGNO (dest)))));
+      else
+	forget_slot (dest);
+    }
+  else if (GET_CODE (dest) == MEM)
+    forget_slot (dest);
+}
+
+/* Scan X for uses of stack pseudos and for side effects on regs.
+   A use of a stack pseudo means the last store into it is not dead.
+   A reg that is incremented or decremented loses its known value,
+   and so do the frame slots, since the address of one may be in it.  */
+
+static void
+note_slot_uses (x)
+     rtx x;
+{
+  register RTX_CODE code = GET_CODE (x);
+  register char *fmt;
+  register int i, j;
+
+  switch (code)
+    {
+    case REG:
+      if (REGNO (x) >= FIRST_PSEUDO_REGISTER && reg_renumber[REGNO (x)] < 0)
+	pending_store[REGNO (x)] = 0;
+      return;
+
+    case PRE_DEC:
+    case PRE_INC:
+    case POST_DEC:
+    case POST_INC:
+      forget_stored_value (XEXP (x, 0));
+      forget_slot (0);
+      break;
+
+    case SET:
+      /* A whole stack pseudo being stored into is not a use of it.  */
+      if (GET_CODE (SET_DEST (x)) == REG)
+	{
+	  note_slot_uses (SET_SRC (x));
+	  return;
+	}
+      break;
+    }
+
+  fmt = GET_RTX_FORMAT (code);
+  for (i = GET_RTX_LENGTH (code) - 1; i >= 0; i--)
+    {
+      if (fmt[i] == 'e')
+	note_slot_uses (XEXP (x, i));
+      else if (fmt[i] == 'E')
+	for (j = XVECLEN (x, i) - 1; j >= 0; j--)
+	  note_slot_uses (XVECEXP (x, i, j));
+    }
+}
+
+/* Return nonzero if X contains an increment or decrement of a reg.  */
+
+static int
+has_auto_inc_p (x)
+     rtx x;
+{
+  register RTX_CODE code = GET_CODE (x);
+  register char *fmt;
+  register int i, j;
+
+  if (code == PRE_DEC || code == PRE_INC || code == POST_DEC || code == POST_INC)
+    return 1;
+
+  fmt = GET_RTX_FORMAT (code);
+  for (i = GET_RTX_LENGTH (code) - 1; i >= 0; i--)
+    {
+      if (fmt[i] == 'e')
+	{
+	  if (has_auto_inc_p (XEXP (x, i)))
+	    return 1;
+	}
+      else if (fmt[i] == 'E')
+	for (j = XVECLEN (x, i) - 1; j >= 0; j--)
+	  if (has_auto_inc_p (XVECEXP (x, i, j)))
+	    return 1;
+    }
+  return 0;
+}
+
+/* Forget all the stores into stack pseudos
+   that have not yet been found to be dead.  */
+
+static void
+forget_pending_stores ()
+{
+  while (n_pending_stores > 0)
+    pending_store[pending_store_regs[--n_pending_stores]] = 0;
+}
+
+/* Turn INSN into a deleted note.  */
+
+static void
+delete_reload_insn (insn)
+     rtx insn;
+{
+  PUT_CODE (insn, NOTE);
+  NOTE_LINE_NUMBER (insn) = NOTE_INSN_DELETED;
+  NOTE_SOURCE_FILE (insn) = 0;
+}
+
+/* Delete the redundant moves in the insns starting at FIRST,
+   after the reload pass has been run on them.
+   If DUMPFILE is nonzero, write to it how many insns were deleted.  */
+
+void
+reload_cse_regs (first, dumpfile)
+     rtx first;
+     FILE *dumpfile;
+{
+  register rtx insn;
+  register int i;
+  int n_loads = 0, n_stores = 0, n_dead_stores = 0, n_self_moves = 0;
+
+  pending_store = (rtx *) alloca (max_regno * sizeof (rtx));
+  bzero (pending_store, max_regno * sizeof (rtx));
+  pending_store_regs = (int *) alloca (max_regno * sizeof (int));
+  n_pending_stores = 0;
+  bzero (hard_reg_slot, sizeof hard_reg_slot);
+
+  for (insn = first; insn; insn = NEXT_INSN (insn))
+    {
+      register RTX_CODE code = GET_CODE (insn);
+      register rtx pat;
+
+      /* Nothing is known at the start of a basic block.  */
+      if (code == CODE_LABEL)
+	{
+	  bzero (hard_reg_slot, sizeof hard_reg_slot);
+	  forget_pending_stores ();
+	  continue;
+	}
+
+      if (code != INSN && code != JUMP_INSN && code != CALL_INSN)
+	continue;
+
+      pat = PATTERN (insn);
+
+      if (GET_CODE (pat) == ASM_INPUT)
+	{
+	  bzero (hard_reg_slot, sizeof hard_reg_slot);
+	  forget_pending_stores ();
+	  continue;
+	}
+
+      if (code == INSN && GET_CODE (pat) == SET)
+	{
+	  register rtx dest = SET_DEST (pat);
+	  register rtx src = SET_SRC (pat);
+	  register int regno;
+
+	  /* A move of a reg into itself.  */
+	  if (GET_CODE (dest) == REG && GET_CODE (src) == REG
+	      && GET_MODE (dest) == GET_MODE (src)
+	      && (reload_hard_regno (dest) >= 0
+		  ? reload_hard_regno (dest) == reload_hard_regno (src)
+		  : REGNO (dest) == REGNO (src)))
+	    {
+	      delete_reload_insn (insn);
+	      n_self_moves++;
+	      continue;
+	    }
+
+	  /* A load of a slot into a hard reg that already holds it.  */
+	  if (GET_CODE (dest) == REG
+	      && (regno = reload_hard_regno (dest)) >= 0
+	      && reload_slot_p (src)
+	      && hard_reg_slot[regno] != 0
+	      && GET_MODE (hard_reg_slot[regno]) == GET_MODE (dest)
+	      && GET_MODE (src) == GET_MODE (dest)
+	      && rtx_equal_p (hard_reg_slot[regno], src))
+	    {
+	      delete_reload_insn (insn);
+	      n_loads++;
+	      continue;
+	    }
+
+	  /* A store of a hard reg into a slot that already holds it.  */
+	  if (GET_CODE (src) == REG
+	      && (regno = reload_hard_regno (src)) >= 0
+	      && reload_slot_p (dest)
+	      && hard_reg_slot[regno] != 0
+	      && GET_MODE (hard_reg_slot[regno]) == GET_MODE (src)
+	      && GET_MODE (src) == GET_MODE (dest)
+	      && rtx_equal_p (hard_reg_slot[regno], dest))
+	    {
+	      delete_reload_insn (insn);
+	      n_stores++;
+	      continue;
+	    }
+	}
+
+      note_slot_uses (pat);
+
+      /* A store into a whole stack pseudo kills the previous store
+	 into it, if that has not been used.  */
+      if (code == INSN && GET_CODE (pat) == SET
+	  && GET_CODE (SET_DEST (pat)) == REG
+	  && reload_slot_p (SET_DEST (pat))
+	  && ! has_auto_inc_p (SET_SRC (pat)))
+	{
+	  register int regno = REGNO (SET_DEST (pat));
+	  if (pending_store[regno] != 0)
+	    {
+	      delete_reload_insn (pending_store[regno]);
+	      n_dead_stores++;
+	    }
+	  else
+	    pending_store_regs[n_pending_stores++] = regno;
+	  pending_store[regno] = insn;
+	}
+
+      /* Forget the values of whatever this insn stores into.  */
+      if (GET_CODE (pat) == SET || GET_CODE (pat) == CLOBBER)
+	forget_stored_value (SET_DEST (pat));
+      else if (GET_CODE (pat) == PARALLEL)
+	for (i = XVECLEN (pat, 0) - 1; i >= 0; i--)
+	  {
+	    register rtx y = XVECEXP (pat, 0, i);
+	    if (GET_CODE (y) == SET || GET_CODE (y) == CLOBBER)
+	      forget_stored_value (SET_DEST (y));
+	  }
+
+      /* A call clobbers some hard regs and may store into any memory.  */
+      if (code == CALL_INSN)
+	{
+	  for (i = 0; i < FIRST_PSEUDO_REGISTER; i++)
+	    if (call_clobbered_regs[i])
+	      forget_hard_regs (i, 1);
+	  forget_slot (0);
+	}
+
+      /* Record the slot a hard reg now holds,
+	 if this insn copies one into the other.  */
+      if (code == INSN && GET_CODE (pat) == SET
+	  && GET_MODE (SET_DEST (pat)) == GET_MODE (SET_SRC (pat)))
+	{
+	  register rtx dest = SET_DEST (pat);
+	  register rtx src = SET_SRC (pat);
+	  register int regno;
+
+	  if (GET_CODE (dest) == REG
+	      && (regno = reload_hard_regno (dest)) >= 0
+	      && reload_slot_p (src))
+	    hard_reg_slot[regno] = src;
+	  else if (GET_CODE (src) == REG
+		   && (regno = reload_hard_regno (src)) >= 0
+		   && reload_slot_p (dest))
+	    hard_reg_slot[regno] = dest;
+	}
+
+      /* A store before a jump may be used where the jump goes.  */
+      if (code == JUMP_INSN)
+	forget_pending_stores ();
+    }
+
+  if (dumpfile)
+    fprintf (dumpfile, ";; After reload: deleted %d loads, %d stores, %d dead stores and %d self-moves.\n\n",
+	     n_loads, n_stores, n_dead_stores, n_self_moves);
+}
@@ -315,6 +315,7 @@ extern void emit_barrier ();
 extern void emit_note ();
 extern rtx prev_real_insn ();
 extern rtx next_real_insn ();
+extern rtx jumps_to_label ();
 extern rtx plus_constant ();
 extern rtx find_equiv_reg ();
 #ifdef BITS_PER_WORD
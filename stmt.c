@@ -68,6 +68,49 @@ static rtx tail_recursion_label;
 static rtx tail_recursion_reentry;
 
 static int tail_recursion_args ();
+
+/* A node of the code for a switch statement: a range of index values
+   that go to one label, or a run of ranges dispatched by a table.  */
+
+struct case_node
+{
+  int low, high;		/* Least and greatest index values covered */
+  rtx label;			/* Label to go to, or 0 for a table */
+  int first, last;		/* For a table, the ranges it contains */
+};
+
+/* Minimum percentage of the values in the span of a dispatch table
+   that must be case values.  -fcase-density=N.  */
+
+extern int case_density;
+
+/* A dispatch table is made only for at least this many ranges.  */
+
+#ifdef HAVE_casesi
+#define CASE_TABLE_MIN 4
+#else
+/* If machine does not have a case insn that compares the
+   bounds, this means extra overhead for dispatch tables
+   which raises the threshold for using them.  */
+#define CASE_TABLE_MIN 7
+#endif
+
+/* A dispatch table never spans more than this many values.  */
+
+#define CASE_TABLE_MAX 16384
+
+/* Groups of this many nodes or fewer are tested one by one
+   rather than by binary search.  */
+
+#define CASE_LINEAR_MAX 3
+
+/* Nonzero if the case values being sorted are unsigned.  */
+
+static int case_unsignedp;
+
+static int case_node_compare ();
+static void emit_case_nodes ();
+static void emit_case_node ();
 
 /* Estimate the complexity of the compiled code for STMT.
    This is a rough estimate and is used for purposes
@@ -672,72 +715,41 @@ tail_recursion_args (actuals, formals)
 }
 
 /* Generate code for a CASE_STMT node,
-   which stands for a dispatch table.  */
+   which stands for a dispatch table.
+
+   The case values are sorted, and consecutive values that go to the
+   same label are made into a single range.  Runs of ranges that fill
+   at least `case_density' percent of their span become dispatch tables.
+   The index is then compared against the ranges and tables by a
+   balanced binary search, so dispatch takes time logarithmic in the
+   number of cases even when they are sparse.  */
 
 static void
 expand_case_stmt (stmt)
      tree stmt;
 {
-   tree minval, maxval, range;
    rtx default_label = 0;
    register tree elt;
    register tree c;
-   int count;
-   tree index_exp;
+   tree index_exp = STMT_CASE_INDEX (stmt);
+   tree index_type = TREE_TYPE (index_exp);
    rtx index;
-   rtx table_label = gen_label_rtx ();
-   int ncases;
-   rtx *labelvec;
-   register int i;
+   struct case_node *ranges, *nodes;
+   double *rest;
+   int nvalues, nranges, nnodes;
+   register int i, j;
 
-   /* Get upper and lower bounds of case values.  */
-   count = 0;
    for (c = STMT_CASE_LIST (stmt); c; c = TREE_CHAIN (c))
-     if (elt = TREE_PURPOSE (c))
-       {
-	 /* Note that in Pascal it will be possible
-	    to have a RANGE_EXPR here as long as both
-	    ends of the range are constant.
-	    It will be necessary to extend this function
-	    to handle them.  */
-	 if (TREE_CODE (elt) != INTEGER_CST)
-	   abort ();
-
-	 if (count++ == 0)
-	   {
-	     minval = maxval = elt;
-	   }
-	 else
-	   {
-	     if (INT_CST_LT (elt, minval))
-	       minval = elt;
-	     if (INT_CST_LT (maxval, elt))
-	       maxval = elt;
-	   }
-       }
-     else
+     if (TREE_PURPOSE (c) == 0)
        default_label = label_rtx (TREE_VALUE (c));
 
    if (default_label == 0)
      abort ();
 
-   /* Compute span of values.  */
-   range = combine (MINUS_EXPR, maxval, minval);
-
-   /* If range of values is much bigger than number of values,
-      make a sequence of conditional branches instead of a dispatch.  */
-   if (TREE_INT_CST_HIGH (range) != 0
-#ifdef HAVE_casesi
-       || count < 4
-#else
-       /* If machine does not have a case insn that compares the
-	  bounds, this means extra overhead for dispatch tables
-	  which raises the threshold for using them.  */
-       || count < 7
-#endif
-       || TREE_INT_CST_LOW (range) > 10 * count)
+   /* An index wider than a word is compared with each value in turn.  */
+   if (GET_MODE_SIZE (TYPE_MODE (index_type)) > GET_MODE_SIZE (SImode))
      {
-       index_exp = get_unwidened (STMT_CASE_INDEX (stmt), 0);
+       index_exp = get_unwidened (index_exp, 0);
        index = expand_expr (index_exp, 0, VOIDmode, 0);
        emit_queue ();
 
@@ -756,76 +768,255 @@ expand_case_stmt (stmt)
        return;
      }
 
-   index_exp = STMT_CASE_INDEX (stmt);
+   /* Collect the values that the index can have, and sort them.  */
 
-#ifdef HAVE_casesi
-   if (TYPE_MODE (TREE_TYPE (index_exp)) == DImode)
+   nvalues = 0;
+   for (c = STMT_CASE_LIST (stmt); c; c = TREE_CHAIN (c))
+     nvalues++;
+   ranges = (struct case_node *) alloca (nvalues * sizeof (struct case_node));
+
+   nvalues = 0;
+   for (c = STMT_CASE_LIST (stmt); c; c = TREE_CHAIN (c))
+     if (elt = TREE_PURPOSE (c))
+       {
+	 /* Note that in Pascal it will be possible
+	    to have a RANGE_EXPR here as long as both
+	    ends of the range are constant.
+	    It will be necessary to extend this function
+	    to handle them.  */
+	 if (TREE_CODE (elt) != INTEGER_CST)
+	   abort ();
+
+	 if (! int_fits_type_p (elt, index_type))
+	   continue;
+	 ranges[nvalues].low = ranges[nvalues].high = TREE_INT_CST_LOW (elt);
+	 ranges[nvalues].label = label_rtx (TREE_VALUE (c));
+	 nvalues++;
+       }
+
+   /* The index is compared as an int, unless it is an unsigned int.
+     Narrower types are converted to int, which holds all their values.  */
+   case_unsignedp = (TREE_UNSIGNED (index_type)
+		     && TYPE_MODE (index_type) == SImode);
+   qsort (ranges, nvalues, sizeof (struct case_node), case_node_compare);
+
+   /* Merge consecutive values that go to the same label.  */
+
+   nranges = 0;
+   for (i = 0; i < nvalues; i++)
      {
-       index_exp = build2 (MINUS_EXPR, index_exp, minval);
-       TREE_TYPE (index_exp) = TREE_TYPE (STMT_CASE_INDEX (stmt));
-       index_exp = convert (integer_type_node, index_exp);
-       minval = integer_zero_node;
+       if (nranges > 0
+	   && ranges[i].label == ranges[nranges - 1].label
+	   && ((unsigned) ranges[i].low
+	       == (unsigned) ranges[nranges - 1].high + 1))
+	 ranges[nranges - 1].high = ranges[i].high;
+       else if (nranges == 0
+		|| ranges[i].low != ranges[nranges - 1].high)
+	 ranges[nranges++] = ranges[i];
      }
-   else if (TYPE_MODE (TREE_TYPE (index_exp)) != SImode)
+
+   /* Group the ranges into nodes.  From each range, take the longest
+      run of ranges that is dense enough for a table, if there are
+      enough of them; otherwise the range is a node by itself.
+      REST[I] is the number of values in ranges I and above; a run from I
+      whose span needs more values than that can stop growing.  */
+
+   rest = (double *) alloca ((nranges + 1) * sizeof (double));
+   rest[nranges] = 0;
+   for (i = nranges - 1; i >= 0; i--)
+     rest[i] = (rest[i + 1]
+		+ (double) (unsigned) (ranges[i].high - ranges[i].low) + 1);
+
+   nodes = (struct case_node *) alloca ((nranges + 1) * sizeof (struct case_node));
+   nnodes = 0;
+   for (i = 0; i < nranges; i = j + 1)
+     {
+       double values = 0;
+       int best = i;
+
+       for (j = i; j < nranges; j++)
+	 {
+	   double span
+	     = (double) (unsigned) (ranges[j].high - ranges[i].low) + 1;
+
+	   if (span > CASE_TABLE_MAX
+	       || span * case_density > rest[i] * 100)
+	     break;
+	   values += (double) (unsigned) (ranges[j].high - ranges[j].low) + 1;
+	   if (j - i + 1 >= CASE_TABLE_MIN
+	       && values * 100 >= span * case_density)
+	     best = j;
+	 }
+
+       j = best;
+       nodes[nnodes].low = ranges[i].low;
+       nodes[nnodes].high = ranges[j].high;
+       nodes[nnodes].first = i;
+       nodes[nnodes].last = j;
+       nodes[nnodes].label = (i == j ? ranges[i].label : 0);
+       nnodes++;
+     }
+
+   /* Compute the index into a register.  */
+
+   if (TYPE_MODE (index_type) != SImode)
      index_exp = convert (integer_type_node, index_exp);
    index = expand_expr (index_exp, 0, VOIDmode, 0);
    emit_queue ();
    index = protect_from_queue (index, 0);
+   if (GET_CODE (index) != REG)
+     index = copy_to_reg (index);
    do_pending_stack_adjust ();
 
-   emit_jump_insn (gen_casesi (index, expand_expr (minval, 0, VOIDmode, 0),
-			       expand_expr (range, 0, VOIDmode, 0),
-			       table_label));
+   emit_case_nodes (index, nodes, 0, nnodes - 1, ranges, default_label);
+}
+
+/* Comparison function for qsort: order case nodes by their low values,
+   compared as unsigned if `case_unsignedp'.  */
+
+static int
+case_node_compare (n1, n2)
+     struct case_node *n1, *n2;
+{
+  if (case_unsignedp)
+    {
+      if ((unsigned) n1->low != (unsigned) n2->low)
+	return (unsigned) n1->low < (unsigned) n2->low ? -1 : 1;
+    }
+  else if (n1->low != n2->low)
+    return n1->low < n2->low ? -1 : 1;
+
+  /* Keep duplicates in the order they were written.  */
+  return n1 < n2 ? -1 : 1;
+}
+
+/* Emit a binary search on the SImode register INDEX for the nodes
+   NODES[LO] through NODES[HI], in increasing order of values, jumping
+   to DEFAULT_LABEL if the index is in none of them.  RANGES is the
+   vector of ranges that tables refer to.  */
+
+static void
+emit_case_nodes (index, nodes, lo, hi, ranges, default_label)
+     rtx index;
+     struct case_node *nodes;
+     int lo, hi;
+     struct case_node *ranges;
+     rtx default_label;
+{
+  register int i, mid;
+  rtx left_label;
+
+  if (hi - lo < CASE_LINEAR_MAX)
+    {
+      for (i = lo; i <= hi; i++)
+	emit_case_node (index, &nodes[i], ranges, default_label);
+      emit_jump (default_label);
+      return;
+    }
+
+  /* Test against the middle node and search the half that
+     may contain the index.  */
+
+  mid = (lo + hi + 1) / 2;
+  left_label = gen_label_rtx ();
+  emit_cmp_insn (index, gen_rtx (CONST_INT, VOIDmode, nodes[mid].low),
+		 0, case_unsignedp);
+  emit_jump_insn (case_unsignedp ? gen_bltu (left_label)
+		  : gen_blt (left_label));
+  emit_case_nodes (index, nodes, mid, hi, ranges, default_label);
+  emit_label (left_label);
+  emit_case_nodes (index, nodes, lo, mid - 1, ranges, default_label);
+}
+
+/* Emit code to jump to the label of NODE if INDEX is within it;
+   otherwise, control falls through.  */
+
+static void
+emit_case_node (index, node, ranges, default_label)
+     rtx index;
+     struct case_node *node;
+     struct case_node *ranges;
+     rtx default_label;
+{
+  rtx low = gen_rtx (CONST_INT, VOIDmode, node->low);
+  rtx high = gen_rtx (CONST_INT, VOIDmode, node->high);
+  rtx table_label, next_label;
+  rtx *labelvec;
+  int ncases;
+  register int i, j;
+
+  if (node->label != 0 && node->low == node->high)
+    {
+      emit_cmp_insn (index, low, 0, case_unsignedp);
+      emit_jump_insn (gen_beq (node->label));
+      return;
+    }
+
+  if (node->label != 0)
+    {
+      next_label = gen_label_rtx ();
+      emit_cmp_insn (index, low, 0, case_unsignedp);
+      emit_jump_insn (case_unsignedp ? gen_bltu (next_label)
+		      : gen_blt (next_label));
+      emit_cmp_insn (index, high, 0, case_unsignedp);
+      emit_jump_insn (case_unsignedp ? gen_bleu (node->label)
+		      : gen_ble (node->label));
+      emit_label (next_label);
+      return;
+    }
+
+  /* Dispatch through a table.  An index outside the table
+     falls through past it.  */
+
+  ncases = (unsigned) (node->high - node->low) + 1;
+  table_label = gen_label_rtx ();
+
+#ifdef HAVE_casesi
+  emit_jump_insn (gen_casesi (index, low,
+			      gen_rtx (CONST_INT, VOIDmode, ncases - 1),
+			      table_label));
 #else
 #ifdef HAVE_tablejump
-   index_exp = build2 (MINUS_EXPR, index_exp, minval);
-   TREE_TYPE (index_exp) = TREE_TYPE (STMT_CASE_INDEX (stmt));
-   index_exp = convert (integer_type_node, index_exp);
-   index = expand_expr (index_exp, 0, VOIDmode, 0);
-   emit_queue ();
-   index = protect_from_queue (index, 0);
-   do_pending_stack_adjust ();
-
-   do_tablejump (index,
-		 gen_rtx (CONST_INT, VOIDmode, TREE_INT_CST_LOW (range)),
-		 table_label, default_label);
+  next_label = gen_label_rtx ();
+  do_tablejump (expand_binop (SImode, sub_optab, index, low, 0, 0,
+			      OPTAB_LIB_WIDEN),
+		gen_rtx (CONST_INT, VOIDmode, ncases - 1),
+		table_label, next_label);
 #else
-   lossage;
+  lossage;
 #endif /* not HAVE_tablejump */
 #endif /* not HAVE_casesi */
 
-   /* Get table of labels to jump to, in order of case index.  */
-
-   ncases = TREE_INT_CST_LOW (range) + 1;
-   labelvec = (rtx *) alloca (ncases * sizeof (rtx));
-   bzero (labelvec, ncases * sizeof (rtx));
-
-   for (c = STMT_CASE_LIST (stmt); c; c = TREE_CHAIN (c))
-     if (elt = TREE_PURPOSE (c))
-       {
-	 register int i = TREE_INT_CST_LOW (elt) - TREE_INT_CST_LOW (minval);
-	 labelvec[i] = gen_rtx (LABEL_REF, Pmode, label_rtx (TREE_VALUE (c)));
-       }
+  /* Get table of labels to jump to, in order of case index.
+     Fill in the gaps with the default.  */
 
-   /* Fill in the gaps with the default.  */
-   for (i = 0; i < ncases; i++)
-     if (labelvec[i] == 0)
-       labelvec[i] = gen_rtx (LABEL_REF, Pmode, default_label);
+  labelvec = (rtx *) alloca (ncases * sizeof (rtx));
+  for (i = 0; i < ncases; i++)
+    labelvec[i] = 0;
+  for (i = node->first; i <= node->last; i++)
+    for (j = ranges[i].low - node->low; j <= ranges[i].high - node->low; j++)
+      labelvec[j] = gen_rtx (LABEL_REF, Pmode, ranges[i].label);
+  for (i = 0; i < ncases; i++)
+    if (labelvec[i] == 0)
+      labelvec[i] = gen_rtx (LABEL_REF, Pmode, default_label);
 
-   /* Output the table */
-   emit_label (table_label);
+  /* Output the table */
+  emit_label (table_label);
 
 #ifdef CASE_VECTOR_PC_RELATIVE
-   emit_jump_insn (gen_rtx (ADDR_DIFF_VEC, CASE_VECTOR_MODE,
-			    gen_rtx (LABEL_REF, Pmode, table_label),
-			    gen_rtvec_v (ncases, labelvec)));
+  emit_jump_insn (gen_rtx (ADDR_DIFF_VEC, CASE_VECTOR_MODE,
+			   gen_rtx (LABEL_REF, Pmode, table_label),
+			   gen_rtvec_v (ncases, labelvec)));
 #else
-   emit_jump_insn (gen_rtx (ADDR_VEC, CASE_VECTOR_MODE,
-			    gen_rtvec_v (ncases, labelvec)));
+  emit_jump_insn (gen_rtx (ADDR_VEC, CASE_VECTOR_MODE,
+			   gen_rtvec_v (ncases, labelvec)));
+#endif
+
+#ifndef HAVE_casesi
+  emit_label (next_label);
 #endif
-   emit_jump (default_label);
 }
-
+
 /* Find all the variables declared within a function
    and give them rtl definitions.  */
 
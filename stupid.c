@@ -47,6 +47,7 @@ and this notice must be preserved on all copies.  */
 #include "rtl.h"
 #include "hard-reg-set.h"
 #include "regs.h"
+#include "basic-block.h"
 #include "stupid.h"
 
 /* Two vectors of length `first_temp_reg_num'
@@ -72,7 +73,7 @@ static HARD_REG_SET reg_class_contents[] = REG_CLASS_CONTENTS;
    We use them to see whether a subroutine call came
    between a variable's birth and its death.  */
 
-static short *uid_suid;
+static int *uid_suid;
 
 /* Get the suid of an insn.  */
 
@@ -86,15 +87,15 @@ static int last_call_suid;
 /* Element N is suid of insn where life span of pseudo reg N ends.
    Element is  0 if register N has not been seen yet on backward scan.  */
 
-static short *reg_where_dead;
+static int *reg_where_dead;
 
 /* Element N is suid of insn where life span of pseudo reg N begins.  */
 
-static short *reg_where_born;
+static int *reg_where_born;
 
 /* Numbers of pseudo-regs to be allocated, highest priority first.  */
 
-static short *reg_order;
+static int *reg_order;
 
 /* Indexed by reg number (hard or pseudo), nonzero if register is live
    at the current point in the instruction stream.  */
@@ -143,7 +144,7 @@ stupid_life_analysis (f, nregs, file)
       i = INSN_UID (insn);
 
   max_uid = i + 1;
-  uid_suid = (short *) alloca ((i + 1) * sizeof (short));
+  uid_suid = (int *) alloca ((i + 1) * sizeof (int));
 
   /* Compute the mapping from uids to suids.
      Suids are numbers assigned to insns, like uids,
@@ -164,14 +165,14 @@ stupid_life_analysis (f, nregs, file)
 
   /* Allocate tables to record info about regs.  */
 
-  reg_where_dead = (short *) alloca (nregs * sizeof (short));
-  bzero (reg_where_dead, nregs * sizeof (short));
+  reg_where_dead = (int *) alloca (nregs * sizeof (int));
+  bzero (reg_where_dead, nregs * sizeof (int));
 
-  reg_where_born = (short *) alloca (nregs * sizeof (short));
-  bzero (reg_where_born, nregs * sizeof (short));
+  reg_where_born = (int *) alloca (nregs * sizeof (int));
+  bzero (reg_where_born, nregs * sizeof (int));
 
-  reg_order = (short *) alloca (nregs * sizeof (short));
-  bzero (reg_order, nregs * sizeof (short));
+  reg_order = (int *) alloca (nregs * sizeof (int));
+  bzero (reg_order, nregs * sizeof (int));
 
   reg_renumber = (short *) oballoc (nregs * sizeof (short));
   for (i = 0; i < FIRST_PSEUDO_REGISTER; i++)
@@ -196,8 +197,11 @@ stupid_life_analysis (f, nregs, file)
     }
 
   /* Allocate and zero out many data structures
-     that will record the data from lifetime analysis.  */
+     that will record the data from lifetime analysis.
+     There are no basic blocks here, so no regsets are made for them;
+     otherwise the count left from the last function would be used.  */
 
+  n_basic_blocks = 0;
   allocate_for_life_analysis ();
 
   for (i = 0; i < max_regno; i++)
@@ -275,7 +279,7 @@ stupid_life_analysis (f, nregs, file)
     reg_order[i] = i;
 
   qsort (&reg_order[FIRST_PSEUDO_REGISTER],
-	 max_regno - FIRST_PSEUDO_REGISTER, sizeof (short),
+	 max_regno - FIRST_PSEUDO_REGISTER, sizeof (int),
 	 stupid_reg_better_p);
 
   /* Now, in that order, try to find hard registers for those pseudo regs.  */
@@ -312,7 +316,7 @@ stupid_life_analysis (f, nregs, file)
 
 static int
 stupid_reg_better_p (r1p, r2p)
-     short *r1p, *r2p;
+     int *r1p, *r2p;
 {
   register int r1 = *r1p, r2 = *r2p;
   register int len1 = reg_where_dead[r1] - reg_where_born[r1];
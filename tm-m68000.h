@@ -690,6 +690,12 @@ enum reg_class { NO_REGS, DATA_REGS, ADDR_REGS, GENERAL_REGS, FP_REGS, FP_OR_DAT
    in one reasonably fast instruction.  */
 #define MOVE_MAX 4
 
+/* There is no block move insn, so rather than call bcopy or bzero,
+   move blocks of up to 1024 bytes by a loop of four moves at a time.  */
+#define MOVE_RATIO 6
+#define BLOCK_MOVE_LOOP_MAX 1024
+#define BLOCK_MOVE_UNROLL 4
+
 /* Define this if zero-extension is slow (more than one real instruction).  */
 #define SLOW_ZERO_EXTEND
 
@@ -728,6 +734,35 @@ enum reg_class { NO_REGS, DATA_REGS, ADDR_REGS, GENERAL_REGS, FP_REGS, FP_OR_DAT
     return 3;							\
   case CONST_DOUBLE:						\
     return 5;
+
+/* Like CONST_COSTS but applies to nonconstant RTL expressions.
+   This can be used, for example, to indicate how costly a multiply
+   instruction is.  Only operations much slower than an add
+   need be described here.  Without the 68020, a fullword multiply
+   or divide is a library call; a shift by more than 8 takes two
+   instructions.  */
+
+#define RTX_COSTS(RTX,CODE) \
+  case MULT:							\
+    /* Scaling by a power of 2 is as cheap as a shift.  */	\
+    if (GET_CODE (XEXP (RTX, 1)) == CONST_INT			\
+	&& (INTVAL (XEXP (RTX, 1)) & (INTVAL (XEXP (RTX, 1)) - 1)) == 0) \
+      break;							\
+    /* SImode ones are library calls without the 68020.  */	\
+    return (TARGET_68020 || GET_MODE (RTX) != SImode ? 24 : 100); \
+  case DIV:							\
+  case UDIV:							\
+  case MOD:							\
+  case UMOD:							\
+    return (TARGET_68020 || GET_MODE (RTX) != SImode ? 60 : 300); \
+  case ASHIFT:							\
+  case LSHIFT:							\
+  case ASHIFTRT:						\
+  case LSHIFTRT:						\
+    if (GET_CODE (XEXP (RTX, 1)) == CONST_INT			\
+	&& (unsigned) INTVAL (XEXP (RTX, 1)) > 8)		\
+      return 8;							\
+    break;
 
 /* Tell final.c how to eliminate redundant test instructions.  */
 
@@ -866,7 +901,7 @@ do { union { float f; long l;} tem;			\
 
 #define PRINT_OPERAND(FILE, X)  \
 { if (GET_CODE (X) == REG)						\
-    fprintf (FILE, "%s", reg_name [REGNO (X)]);				\
+    fputs (reg_name [REGNO (X)], FILE);					\
   else if (GET_CODE (X) == MEM)						\
     output_address (XEXP (X, 0));					\
   else if (GET_CODE (X) == CONST_DOUBLE && GET_MODE (X) == SFmode)	\
@@ -513,6 +513,12 @@ enum reg_class { NO_REGS, ALL_REGS, LIM_REG_CLASSES };
    in one reasonably fast instruction.  */
 #define MOVE_MAX 16
 
+/* movc3 is slow to start and clobbers r0 through r5, so blocks
+   of up to 256 bytes are moved by a loop of four moves at a time.  */
+#define MOVE_RATIO 3
+#define BLOCK_MOVE_LOOP_MAX 256
+#define BLOCK_MOVE_UNROLL 4
+
 /* Define this if zero-extension is slow (more than one real instruction).  */
 /* #define SLOW_ZERO_EXTEND */
 
@@ -551,6 +557,28 @@ enum reg_class { NO_REGS, ALL_REGS, LIM_REG_CLASSES };
     return 3;							\
   case CONST_DOUBLE:						\
     return 5;
+
+/* Like CONST_COSTS but applies to nonconstant RTL expressions.
+   This can be used, for example, to indicate how costly a multiply
+   instruction is.  Only operations much slower than an add
+   need be described here.  */
+
+#define RTX_COSTS(RTX,CODE) \
+  case MULT:							\
+    /* Scaling by a power of 2 is as cheap as a shift.  */	\
+    if (GET_CODE (XEXP (RTX, 1)) == CONST_INT			\
+	&& (INTVAL (XEXP (RTX, 1)) & (INTVAL (XEXP (RTX, 1)) - 1)) == 0) \
+      break;							\
+    return 16;							\
+  case DIV:							\
+    return 40;							\
+  case MOD:							\
+    /* Divide, multiply and subtract.  */			\
+    return 60;							\
+  case UDIV:							\
+  case UMOD:							\
+    /* These are library calls.  */				\
+    return 100;
 
 /* Tell final.c how to eliminate redundant test instructions.  */
 
@@ -660,7 +688,7 @@ enum reg_class { NO_REGS, ALL_REGS, LIM_REG_CLASSES };
 
 #define PRINT_OPERAND(FILE, X)  \
 { if (GET_CODE (X) == REG)						\
-    fprintf (FILE, "%s", reg_name [REGNO (X)]);				\
+    fputs (reg_name [REGNO (X)], FILE);					\
   else if (GET_CODE (X) == MEM)						\
     output_address (XEXP (X, 0));					\
   else if (GET_CODE (X) == CONST_DOUBLE)				\
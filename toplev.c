@@ -51,6 +51,17 @@ extern rtx expand_function ();
 extern void init_optabs ();
 extern void dump_flow_info ();
 extern void dump_local_alloc ();
+extern void dump_live_range_splits ();
+extern void reload_cse_regs ();
+extern void dump_jump_stats ();
+extern void dump_jump_total_stats ();
+extern void dump_constant_stats ();
+
+/* Size of the stdio buffer for the assembler output file.  */
+
+#ifndef ASM_OUT_BUFFER_SIZE
+#define ASM_OUT_BUFFER_SIZE 16384
+#endif
 
 /* Bit flags that specify the machine subtype we are compiling for.
    Bits are tested using macros TARGET_... defined in the tm-...h file
@@ -114,6 +125,29 @@ int force_addr = 0;
 
 int obey_regdecls = 0;
 
+/* Nonzero means unroll loops whose trip count is known at compile time.
+   -funroll-loops.  Has no effect without -opt.  */
+
+int unroll_loops = 0;
+
+/* Nonzero means global-alloc should color the conflict graph,
+   coalescing copies, instead of allocating pseudos in priority order.
+   -fcolor-regs.  */
+
+int color_regs = 0;
+
+/* Nonzero means give long-lived pseudo regs separate pseudo regs
+   within the loops that use them.  -fsplit-live-ranges.
+   Has no effect without -opt.  */
+
+int split_live_ranges = 0;
+
+/* Minimum percentage of the values in its span that must be case values
+   for a run of cases of a switch statement to get a dispatch table.
+   -fcase-density=N.  */
+
+int case_density = 10;
+
 /* Don't print functions as they are compiled and don't print
    times taken by the various passes.  -quiet.  */
 
@@ -190,7 +224,9 @@ print_time (str, total)
      char *str;
      int total;
 {
-  printf ("time in %s: %d.%06d\n", str, total / 1000000, total % 1000000);
+  /* Keep the times out of the assembler code if that is on stdout.  */
+  fprintf (asm_out_file == stdout ? stderr : stdout,
+	   "time in %s: %d.%06d\n", str, total / 1000000, total % 1000000);
 }
 
 /* Count an error or warning.  Return 1 if the message should be printed.  */
@@ -521,9 +557,20 @@ compile_file (name)
     register char *dumpname = (char *) xmalloc (dump_base_name_length + 6);
     strcpy (dumpname, dump_base_name);
     strcat (dumpname, ".s");
-    asm_out_file = fopen (asm_file_name ? asm_file_name : dumpname, "w");
+    /* `-o -' means write the assembler code on the standard output,
+       which the driver may have made a pipe to the assembler.  */
+    if (asm_file_name && !strcmp (asm_file_name, "-"))
+      asm_out_file = stdout;
+    else
+      asm_out_file = fopen (asm_file_name ? asm_file_name : dumpname, "w");
     if (asm_out_file == 0)
       pfatal_with_name (asm_file_name ? asm_file_name : dumpname);
+    /* The assembler code is written a few characters at a time;
+       give it a big buffer so that it goes out in large blocks.
+       Leave the standard output with the buffering stdio gave it.  */
+    if (asm_out_file != stdout)
+      setvbuf (asm_out_file, (char *) xmalloc (ASM_OUT_BUFFER_SIZE),
+	       _IOFBF, ASM_OUT_BUFFER_SIZE);
   }
 
   input_filename = name;
@@ -589,7 +636,14 @@ compile_file (name)
   /* Close non-debugging input and output files.  */
 
   fclose (finput);
-  fclose (asm_out_file);
+  if (asm_out_file == stdout)
+    {
+      fflush (asm_out_file);
+      if (ferror (asm_out_file))
+	pfatal_with_name ("standard output");
+    }
+  else
+    fclose (asm_out_file);
 
   if (!quiet_flag)
     fprintf (stderr,"\n");
@@ -607,13 +661,21 @@ compile_file (name)
     fclose (rtl_dump_file);
 
   if (jump_opt_dump)
-    fclose (jump_opt_dump_file);
+    {
+      if (optimize)
+	dump_jump_total_stats (jump_opt_dump_file);
+      fclose (jump_opt_dump_file);
+    }
 
   if (cse_dump)
     fclose (cse_dump_file);
 
   if (loop_dump)
-    fclose (loop_dump_file);
+    {
+      if (optimize && unroll_loops)
+	dump_loop_total_stats (loop_dump_file);
+      fclose (loop_dump_file);
+    }
 
   if (flow_dump)
     fclose (flow_dump_file);
@@ -647,6 +709,7 @@ compile_file (name)
       print_time ("varconst", varconst_time);
       print_time ("symout", symout_time);
       print_time ("dump", dump_time);
+      dump_constant_stats (asm_out_file == stdout ? stderr : stdout);
     }
 }
 
@@ -731,6 +794,8 @@ rest_of_compilation (decl, top_level)
 		 {
 		   fprintf (jump_opt_dump_file, "\n;; Function %s\n\n",
 			    IDENTIFIER_POINTER (DECL_NAME (decl)));
+		   if (optimize)
+		     dump_jump_stats (jump_opt_dump_file);
 		   print_rtl (jump_opt_dump_file, insns);
 		   fflush (jump_opt_dump_file);
 		 });
@@ -775,6 +840,8 @@ rest_of_compilation (decl, top_level)
 		 {
 		   fprintf (loop_dump_file, "\n;; Function %s\n\n",
 			    IDENTIFIER_POINTER (DECL_NAME (decl)));
+		   if (optimize && unroll_loops)
+		     dump_loop_stats (loop_dump_file);
 		   print_rtl (loop_dump_file, insns);
 		   fflush (loop_dump_file);
 		 });
@@ -881,9 +948,18 @@ rest_of_compilation (decl, top_level)
 			   global_reg_dump ? global_reg_dump_file : 0);
 	       });
 
+      /* Delete the loads and stores that reloading made redundant.  */
+
+      if (optimize)
+	TIMEVAR (global_alloc_time,
+		 reload_cse_regs (insns,
+				  global_reg_dump ? global_reg_dump_file : 0));
+
       if (global_reg_dump)
 	TIMEVAR (dump_time,
 		 {
+		   if (optimize && split_live_ranges)
+		     dump_live_range_splits (global_reg_dump_file);
 		   dump_global_regs (global_reg_dump_file);
 		   print_rtl (global_reg_dump_file, insns);
 		   fflush (global_reg_dump_file);
@@ -1010,6 +1086,20 @@ main (argc, argv, envp)
 	  force_addr = 1;
 	else if (!strcmp (str, "noreg"))
 	  obey_regdecls = 1;
+	else if (!strcmp (str, "funroll-loops"))
+	  unroll_loops = 1;
+	else if (!strcmp (str, "fcolor-regs"))
+	  color_regs = 1;
+	else if (!strcmp (str, "fsplit-live-ranges"))
+	  split_live_ranges = 1;
+	else if (!strncmp (str, "fcase-density=", 14))
+	  {
+	    int density = atoi (str + 14);
+	    if (density < 1 || density > 100)
+	      yylineerror (0, "Invalid switch, %s.", argv[i]);
+	    else
+	      case_density = density;
+	  }
 	else if (!strcmp (str, "w"))
 	  inhibit_warnings = 1;
 	else if (!strcmp (str, "g"))
@@ -42,6 +42,7 @@ extern struct obstack *current_obstack;
 extern struct obstack permanent_obstack;
 #define obstack_chunk_alloc xmalloc
 extern int xmalloc ();
+extern void free ();
 
 /* Number for making the label on the next
    constant that is stored in memory.  */
@@ -297,23 +298,59 @@ decode_addr_const (exp, value)
 
 /* Uniquize all constants that appear in memory.
    Each constant in memory thus far output is recorded
-   in `hash_table' with a `struct constant_descriptor'
+   in `const_hash_table' with a `struct constant_descriptor'
    that contains a polish representation of the value of
-   the constant.
+   the constant, and its full hash code, which is compared
+   before the representation is.
 
    We cannot store the trees in the hash table
-   because the trees may be temporary.  */
+   because the trees may be temporary.
+
+   A string constant that is the tail of one already output
+   is not output again; it is addressed as LABELNO + OFFSET,
+   within the longer one.  To find such strings, each string
+   constant that is output is entered also in `string_tail_table',
+   hashed on its last STRING_TAIL_LENGTH bytes.  */
 
 struct constant_descriptor
 {
   struct constant_descriptor *next;
+  struct constant_descriptor *tail_next;
+  int hash;
   int labelno;
+  int offset;
   char contents[1];
 };
 
 #define HASHBITS 30
-#define MAX_HASH_TABLE 1007
-static struct constant_descriptor *hash_table[MAX_HASH_TABLE];
+
+/* The tables start with CONST_HASH_TABLE_SIZE chains and double in size
+   whenever they hold twice as many constants as they have chains.
+   The size is always a power of 2.  */
+
+#ifndef CONST_HASH_TABLE_SIZE
+#define CONST_HASH_TABLE_SIZE 1024
+#endif
+
+static struct constant_descriptor **const_hash_table;
+static struct constant_descriptor **string_tail_table;
+static int const_hash_table_size;
+static int n_constants;
+
+/* Strings shorter than this are never shared with longer strings.  */
+
+#define STRING_TAIL_LENGTH 8
+
+/* The address of the characters of the string constant
+   described by DESC, which follow its code and its length.  */
+
+#define DESC_STRING(DESC) ((DESC)->contents + 1 + sizeof (int))
+
+/* Number of constants that were found already output, and their bytes;
+   the same for strings found as tails of others.  */
+
+static int n_dup_constants, n_dup_constant_bytes;
+static int n_tail_strings, n_tail_string_bytes;
 
 /* Compute a hash code for a constant expression.  */
 
@@ -338,15 +375,16 @@ const_hash (exp)
   else if (code == STRING_CST)
     p = TREE_STRING_POINTER (exp), len = TREE_STRING_LENGTH (exp);
   else if (code == COMPLEX_CST)
-    return const_hash (TREE_REALPART (exp)) * 5
-      + const_hash (TREE_IMAGPART (exp));
+    return ((const_hash (TREE_REALPART (exp)) * 5
+	     + const_hash (TREE_IMAGPART (exp)))
+	    & ((1 << HASHBITS) - 1));
   else if (code == CONSTRUCTOR)
     {
       register tree link;
       hi = 5;
       for (link = TREE_OPERAND (exp, 0); link; link = TREE_CHAIN (link))
-	hi = (hi * 603 + const_hash (TREE_VALUE (link))) % MAX_HASH_TABLE;
-      return hi;
+	hi = (hi * 603 + const_hash (TREE_VALUE (link)));
+      return hi & ((1 << HASHBITS) - 1);
     }
   else if (code == ADDR_EXPR)
     {
@@ -356,8 +394,9 @@ const_hash (exp)
       len = sizeof value;
     }
   else if (code == PLUS_EXPR || code == MINUS_EXPR)
-    return const_hash (TREE_OPERAND (exp, 0)) * 5
-      +  const_hash (TREE_OPERAND (exp, 1));
+    return ((const_hash (TREE_OPERAND (exp, 0)) * 5
+	     + const_hash (TREE_OPERAND (exp, 1)))
+	    & ((1 << HASHBITS) - 1));
 
   /* Compute hashing function */
   hi = len;
@@ -365,9 +404,131 @@ const_hash (exp)
     hi = ((hi * 613) + (unsigned)(p[i]));
 
   hi &= (1 << HASHBITS) - 1;
-  hi %= MAX_HASH_TABLE;
   return hi;
 }
+
+/* Compute the hash code, for `string_tail_table',
+   of the STRING_TAIL_LENGTH bytes at P.  */
+
+static int
+string_tail_hash (p)
+     register char *p;
+{
+  register int hi = 0;
+  register int i;
+
+  for (i = 0; i < STRING_TAIL_LENGTH; i++)
+    hi = ((hi * 613) + (unsigned)(p[i]));
+
+  return hi & ((1 << HASHBITS) - 1);
+}
+
+/* Return the length of the string constant described by DESC.  */
+
+static int
+desc_string_length (desc)
+     struct constant_descriptor *desc;
+{
+  int len;
+
+  bcopy (desc->contents + 1, &len, sizeof len);
+  return len;
+}
+
+/* Enter DESC, which describes a string constant that has been output,
+   in `string_tail_table'.  */
+
+static void
+record_string_tail (desc)
+     register struct constant_descriptor *desc;
+{
+  register int len = desc_string_length (desc);
+  register int hash;
+
+  if (len < STRING_TAIL_LENGTH)
+    return;
+
+  hash = (string_tail_hash (DESC_STRING (desc) + len - STRING_TAIL_LENGTH)
+	  & (const_hash_table_size - 1));
+  desc->tail_next = string_tail_table[hash];
+  string_tail_table[hash] = desc;
+}
+
+/* Make `const_hash_table' and `string_tail_table' twice as big
+   (or allocate them, the first time) and rehash their contents.  */
+
+static void
+grow_const_hash_table ()
+{
+  struct constant_descriptor **old = const_hash_table;
+  int old_size = const_hash_table_size;
+  register struct constant_descriptor *desc, *next;
+  register int i;
+
+  const_hash_table_size = old ? 2 * old_size : CONST_HASH_TABLE_SIZE;
+  const_hash_table
+    = (struct constant_descriptor **)
+      xmalloc (const_hash_table_size * sizeof (struct constant_descriptor *));
+  bzero (const_hash_table,
+	 const_hash_table_size * sizeof (struct constant_descriptor *));
+  if (string_tail_table)
+    free (string_tail_table);
+  string_tail_table
+    = (struct constant_descriptor **)
+      xmalloc (const_hash_table_size * sizeof (struct constant_descriptor *));
+  bzero (string_tail_table,
+	 const_hash_table_size * sizeof (struct constant_descriptor *));
+
+  for (i = 0; i < old_size; i++)
+    for (desc = old[i]; desc; desc = next)
+      {
+	next = desc->next;
+	desc->next = const_hash_table[desc->hash & (const_hash_table_size - 1)];
+	const_hash_table[desc->hash & (const_hash_table_size - 1)] = desc;
+	if ((enum tree_code) desc->contents[0] == STRING_CST
+	    && desc->offset == 0)
+	  record_string_tail (desc);
+      }
+
+  if (old)
+    free (old);
+}
+
+/* Look for a string constant already output that ends with
+   the string constant EXP.  If there is one, return its descriptor
+   and store in *POFFSET the offset of EXP's string within it.  */
+
+static struct constant_descriptor *
+find_string_tail (exp, poffset)
+     tree exp;
+     int *poffset;
+{
+  register struct constant_descriptor *desc;
+  register char *str = TREE_STRING_POINTER (exp);
+  register int len = TREE_STRING_LENGTH (exp);
+  int hash;
+
+  /* A string at an offset within another is only byte-aligned,
+     whatever the alignment of the other.  */
+  if (len < STRING_TAIL_LENGTH
+      || TYPE_ALIGN (TREE_TYPE (exp)) > BITS_PER_UNIT)
+    return 0;
+
+  hash = string_tail_hash (str + len - STRING_TAIL_LENGTH);
+  for (desc = string_tail_table[hash & (const_hash_table_size - 1)];
+       desc; desc = desc->tail_next)
+    {
+      register int dlen = desc_string_length (desc);
+      if (dlen >= len
+	  && ! bcmp (DESC_STRING (desc) + dlen - len, str, len))
+	{
+	  *poffset = dlen - len;
+	  return desc;
+	}
+    }
+
+  return 0;
+}
 
 /* Compare a constant expression EXP with a constant-descriptor DESC.
    Return 1 if DESC describes a constant with the same value as EXP.  */
@@ -433,6 +594,10 @@ compare_constant_1 (exp, p)
   else if (code == CONSTRUCTOR)
     {
       register tree link;
+      int length = list_length (TREE_OPERAND (exp, 0));
+      if (bcmp (&length, p, sizeof length))
+	return 0;
+      p += sizeof length;
       for (link = TREE_OPERAND (exp, 0); link; link = TREE_CHAIN (link))
 	if ((p = compare_constant_1 (TREE_VALUE (link), p)) == 0)
 	  return 0;
@@ -470,11 +635,14 @@ static struct constant_descriptor *
 record_constant (exp)
      tree exp;
 {
-  struct constant_descriptor *ptr = 0;
-  int buf;
-
-  obstack_grow (&permanent_obstack, &ptr, sizeof ptr);
-  obstack_grow (&permanent_obstack, &buf, sizeof buf);
+  struct constant_descriptor header;
+
+  /* Leave room for the fields that precede the contents;
+     the caller fills them in.  */
+  header.next = 0;
+  header.tail_next = 0;
+  obstack_grow (&permanent_obstack, &header,
+		(char *) header.contents - (char *) &header);
   record_constant_1 (exp);
   return (struct constant_descriptor *) obstack_finish (&permanent_obstack);
 }
@@ -522,7 +690,7 @@ record_constant_1 (exp)
     {
       register tree link;
       int length = list_length (TREE_OPERAND (exp, 0));
-      obstack_grow (&permanent_obstack, (char *) length, sizeof length);
+      obstack_grow (&permanent_obstack, (char *) &length, sizeof length);
 
       for (link = TREE_OPERAND (exp, 0); link; link = TREE_CHAIN (link))
 	record_constant_1 (TREE_VALUE (link));
@@ -547,17 +715,22 @@ record_constant_1 (exp)
   obstack_grow (&permanent_obstack, strp, len);
 }
 
-/* Return the constant-label-number for constant value EXP.
+/* Return the constant-label-number for constant value EXP,
+   and store in *POFFSET the offset of EXP's data from that label.
    If no constant equal to EXP has yet been output,
-   define a new label and output assembler code for it.
-   The hash_table records which constants already have label numbers.  */
+   define a new label and output assembler code for it,
+   unless EXP is a string that is the tail of one already output.
+   The const_hash_table records which constants already have label numbers.  */
 
 int
-get_or_assign_labelno (exp)
+get_or_assign_labelno (exp, poffset)
      tree exp;
+     int *poffset;
 {
   register int hash, i;
   register struct constant_descriptor *desc;
+  struct constant_descriptor *tail;
+  int offset;
 
   /* Make sure any other constants whose addresses appear in EXP
      are assigned label numbers.  */
@@ -568,21 +741,54 @@ get_or_assign_labelno (exp)
      to see if any of them describes EXP.  If yes, the descriptor records
      the label number already assigned.  */
 
-  hash = const_hash (exp) % MAX_HASH_TABLE;
+  if (const_hash_table == 0)
+    grow_const_hash_table ();
 
-  for (desc = hash_table[hash]; desc; desc = desc->next)
-    if (compare_constant (exp, desc))
-      return desc->labelno;
+  hash = const_hash (exp);
+
+  for (desc = const_hash_table[hash & (const_hash_table_size - 1)];
+       desc; desc = desc->next)
+    if (desc->hash == hash && compare_constant (exp, desc))
+      {
+	n_dup_constants++;
+	n_dup_constant_bytes += (TREE_CODE (exp) == STRING_CST
+				 ? TREE_STRING_LENGTH (exp)
+				 : static_size_in_bytes (TREE_TYPE (exp)));
+	*poffset = desc->offset;
+	return desc->labelno;
+      }
 
   /* No constant equal to EXP is known to have been output.
      Make a constant descriptor to enter EXP in the hash table.
-     Assign the label number and record it in the descriptor for
-     future calls to this function to find.  */
+     A string may still lie at the end of one that was output;
+     if so, record its label number and offset in the descriptor.
+     Otherwise assign the label number and record it in the descriptor
+     for future calls to this function to find.  */
+
+  if (++n_constants > 2 * const_hash_table_size)
+    grow_const_hash_table ();
+
+  tail = (TREE_CODE (exp) == STRING_CST
+	  ? find_string_tail (exp, &offset) : 0);
 
   desc = record_constant (exp);
-  desc->next = hash_table[hash];
-  hash_table[hash] = desc;
+  desc->hash = hash;
+  desc->next = const_hash_table[hash & (const_hash_table_size - 1)];
+  const_hash_table[hash & (const_hash_table_size - 1)] = desc;
+
+  if (tail)
+    {
+      n_tail_strings++;
+      n_tail_string_bytes += TREE_STRING_LENGTH (exp);
+      desc->labelno = tail->labelno;
+      desc->offset = *poffset = offset;
+      return desc->labelno;
+    }
+
   desc->labelno = const_labelno++;
+  desc->offset = *poffset = 0;
+  if (TREE_CODE (exp) == STRING_CST)
+    record_string_tail (desc);
 
   /* Now output assembler code to define that label
      and follow it with the data of EXP.  */
@@ -606,6 +812,20 @@ get_or_assign_labelno (exp)
   return desc->labelno;
 }
 
+/* Print on FILE how many constants, and how many bytes of them,
+   were not output again because they were found already output.  */
+
+void
+dump_constant_stats (file)
+     FILE *file;
+{
+  fprintf (file, "constants in %d chains: %d output, %d duplicates (%d bytes)",
+	   const_hash_table_size, const_labelno,
+	   n_dup_constants, n_dup_constant_bytes);
+  fprintf (file, ", %d string tails (%d bytes)\n",
+	   n_tail_strings, n_tail_string_bytes);
+}
+
 /* Return an rtx representing a reference to constant data in memory
    for the constant expression EXP.
    If assembler code for such a constant has already been output,
@@ -619,19 +839,27 @@ output_constant_def (exp)
 {
   register rtx def;
   register int labelno;
+  int offset;
   char *labelstr;
   char label[10];
 
   if (TREE_CST_RTL (exp))
     return TREE_CST_RTL (exp);
 
-  labelno = get_or_assign_labelno (exp);
+  labelno = get_or_assign_labelno (exp, &offset);
 
   sprintf (label, "*LC%d", labelno);
   labelstr = obstack_copy0 (current_obstack, label, strlen (label));
 
   def = gen_rtx (SYMBOL_REF, Pmode, labelstr);
 
+  /* A string that shares the tail of another is addressed
+     as an offset from that one's label.  */
+  if (offset)
+    def = gen_rtx (CONST, Pmode,
+		   gen_rtx (PLUS, Pmode, def,
+			    gen_rtx (CONST_INT, VOIDmode, offset)));
+
   TREE_CST_RTL (exp)
     = gen_rtx (MEM, TYPE_MODE (TREE_TYPE (exp)), def);
 